@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""
+Decode telemetry sent by wifi.c back into names and values.
+
+    python3 telemetry.py capture.bin
+    python3 telemetry.py /dev/ttyUSB0      (after stty -F /dev/ttyUSB0 115200 raw)
+
+Prints one line per frame, name=value for each channel in it, with arrays as
+name=[a, b, ...]. A frame holding a channel whose name hasn't been heard yet
+(see TelemetryAnnounce) is counted and skipped.
+"""
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                '..', '..', 'System Libraries', 'SCI Library'))
+import packet  # noqa: E402
+
+DATA = ord('T')
+NAME = ord('N')
+FLOAT = 0
+
+
+class Telemetry:
+    def __init__(self):
+        self.channels = {}  # number -> (name, count, scale)
+        self.unknown = 0
+
+    def name(self, payload):
+        channel, count = payload[0], payload[1]
+        scale, = struct.unpack('<f', payload[2:6])
+        self.channels[channel] = (payload[6:].decode('ascii', 'replace'), count, scale)
+
+    def frame(self, payload):
+        """[(name, value or [values])] from a TELEMETRY_DATA payload, or None."""
+        out = []
+        i = 0
+        while i < len(payload):
+            if payload[i] not in self.channels:
+                self.unknown += 1
+                return None
+            name, count, scale = self.channels[payload[i]]
+            i += 1
+            if scale == FLOAT:
+                values = list(struct.unpack_from('<%df' % count, payload, i))
+                i += 4 * count
+            else:
+                values = [v / scale for v in struct.unpack_from('<%dh' % count, payload, i)]
+                i += 2 * count
+            out.append((name, values[0] if count == 1 else values))
+        return out
+
+    def feed(self, ptype, payload):
+        if ptype == NAME:
+            self.name(payload)
+        elif ptype == DATA:
+            return self.frame(payload)
+        return None
+
+
+def show(value):
+    if isinstance(value, list):
+        return '[' + ', '.join('%.6g' % v for v in value) + ']'
+    return '%.6g' % value
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__.strip())
+    dec = packet.Decoder()
+    tel = Telemetry()
+    with open(sys.argv[1], 'rb') as f:
+        while True:
+            data = f.read1(4096) if hasattr(f, 'read1') else f.read(4096)
+            if not data:
+                break
+            for ptype, payload in dec.feed(data):
+                values = tel.feed(ptype, payload)
+                if values:
+                    print(' '.join('%s=%s' % (n, show(v)) for n, v in values))
+                    sys.stdout.flush()
+    sys.stderr.write('%d packets, %d thrown away, %d frames with unnamed channels\n' % (
+        dec.packets, dec.errors, tel.unknown))
+
+
+if __name__ == '__main__':
+    main()
@@ -1,51 +1,251 @@
-/**
- * @author Pavel Komarov <pkomarov@gatech.edu> 941-545-7573
- * @author Andrey Kurenkov
- * @author Ricky Liou
- * @author Alex 'Apop' Popescue
- */
-
-#include "F2806x_Device.h"
-#include "28069Common.h"
-#include "wifi.h"
-#include "sci.h"
-#include "string.h"
-#include <stdio.h>
-#include <stdlib.h>
-
-/**
- * Send a single floating-point number with a description
- *
- * @param scisys A or B
- * @param name A string describing the data
- * @param send A float to send
- */
-void sendFloat(char scisys, char* name, float32 send){
-	char* toSend= malloc(sizeof(char)*(strlen(name)+1));//have some padding for non decimal places
-
-	sprintf(toSend,"%s:%.5f", name, send);//"%11.5f specifies a format with 11 total
-	sendString(scisys, toSend);				//characters: 5 digits before the dot, the
-	free(toSend);							//dot itself, and 5 digits after the dot.
-}
-
-/**
- * Send an array of floating-point numbers.
- *
- * @param name A string describing the data
- * @param send An array of floats to send as data
- * @param len The length of the data-array
- */
-void sendFloats(char scisys, char* name, float32* send, Uint16 len) {
-	char* floatStr = (char*) malloc(sizeof(char)*12);//one for ;, one for ., five above ., five below
-	char* toSend = (char*) malloc(sizeof(char)*(strlen(name)+1 + len*12));
-
-	sprintf(toSend,"%s:", name);
-	int i;
-	for(i = 0; i < len; i++){
-		sprintf(floatStr, ";%.5f", send[i]);
-		strcat(toSend, floatStr);
-	}
-	sendString(scisys, toSend);
-	free(toSend);
-	free(floatStr);
-}
+/**
+ * @author Pavel Komarov <pkomarov@gatech.edu> 941-545-7573
+ * @author Andrey Kurenkov
+ * @author Ricky Liou
+ * @author Alex 'Apop' Popescue
+ *
+ * Telemetry goes out as packets (see packet.h), and a value is a channel
+ * number and the value in binary rather than its name and digits in ASCII: 5
+ * bytes for a float32 and 3 for a scaled int16, against about 15. Names go in
+ * TELEMETRY_NAME packets, and telemetry.py puts them back on the other end.
+ * TelemetrySend sends a channel's name ahead of its first frame, retries
+ * until the name has gone, and sends it again every TELEMETRY_RENAME frames
+ * after, so a receiver that missed it (this is a radio) catches up.
+ *
+ * A TELEMETRY_DATA packet holds one or more channels, each as
+ *     channel number, then count values (float32, or int16 = value*scale)
+ * and a TELEMETRY_NAME packet describes one:
+ *     channel number, count, scale (float32, TELEMETRY_FLOAT for float32), name
+ * all little-endian.
+ *
+ * Sending several channels at once costs one packet:
+ *
+ * Uint16 volts = TelemetryChannel("volts", 100, 1);//sent in hundredths
+ * Uint16 temps = TelemetryChannel("temps", TELEMETRY_FLOAT, 4);
+ * ...
+ * TelemetryPut(volts, &v);
+ * TelemetryPut(temps, t);
+ * TelemetrySend(port);
+ */
+
+#include "F2806x_Device.h"
+#include "28069Common.h"
+#include "wifi.h"
+#include "sci.h"
+#include "string.h"
+
+typedef struct {
+	char* name;
+	float32 scale;
+	Uint16 count;
+	Uint16 announced;//its name has been sent
+	Uint16 frames;//frames it has been put in since
+} CHANNEL;
+
+static CHANNEL xchannels[TELEMETRY_CHANNELS];
+static Uint16 xnchannels = 0;
+static PACKET xframe = {TELEMETRY_DATA, 0};//the frame being filled
+static PACKET xname;//a channel's description, on its way out
+static char xnames[TELEMETRY_NAMES];//copies of the names sendFloats was given
+static Uint16 xnamesused = 0;
+
+/**
+ * Bytes a channel takes in a frame.
+ */
+static Uint16 channelSize(CHANNEL* channel) {
+	return 1 + channel->count*(channel->scale == TELEMETRY_FLOAT ? 4 : 2);
+}
+
+/**
+ * Name a channel. Names are kept by pointer, so pass a string literal or one
+ * that otherwise stays put.
+ *
+ * @param name What telemetry.py will call it
+ * @param scale TELEMETRY_FLOAT to send values as float32; otherwise they are
+ * 				sent as int16s of value*scale, so 100 keeps two decimal places
+ * 				of values up to +/-327.67
+ * @param count How many values the channel has
+ * @return The channel number, to pass to TelemetryPut, or TELEMETRY_NONE if
+ * 				there are already TELEMETRY_CHANNELS or count values won't fit
+ * 				in a packet
+ */
+Uint16 TelemetryChannel(char* name, float32 scale, Uint16 count) {
+	CHANNEL* channel = &xchannels[xnchannels];
+
+	if (xnchannels >= TELEMETRY_CHANNELS || count == 0) {
+		return TELEMETRY_NONE;
+	}
+	channel->name = name;
+	channel->scale = scale;
+	channel->count = count;
+	channel->announced = 0;
+	channel->frames = 0;
+	if (channelSize(channel) > PACKET_MAX) {
+		return TELEMETRY_NONE;
+	}
+	return xnchannels++;
+}
+
+/**
+ * Add a channel's values to the frame. Each channel should only go in once
+ * per frame.
+ *
+ * @param channel From TelemetryChannel
+ * @param values As many as the channel has
+ * @return 1, or 0 if the frame is too full (TelemetrySend it and try again)
+ */
+Uint16 TelemetryPut(Uint16 channel, float32* values) {
+	CHANNEL* c = &xchannels[channel];
+	float32 scaled;
+	Uint16 i;
+
+	if (channel >= xnchannels || xframe.length + channelSize(c) > PACKET_MAX) {
+		return 0;
+	}
+	xframe.data[xframe.length++] = channel;
+	c->frames++;
+	for (i = 0; i < c->count; i++) {
+		if (c->scale == TELEMETRY_FLOAT) {
+			PacketPutFloat(&xframe, values[i]);
+			continue;
+		}
+		scaled = values[i]*c->scale;//round to the nearest, saturating
+		scaled = (scaled < 0) ? scaled - 0.5 : scaled + 0.5;
+		if (scaled > 32767) {
+			scaled = 32767;
+		} else if (scaled < -32767) {
+			scaled = -32767;
+		}
+		PacketPutUint16(&xframe, (int16)scaled);
+	}
+	return 1;
+}
+
+/**
+ * Send one channel's description. Only once it has gone is the channel
+ * marked as announced.
+ */
+static Uint16 telemetryName(SCIPORT* port, Uint16 channel) {
+	CHANNEL* c = &xchannels[channel];
+	Uint16 i;
+
+	PacketInit(&xname, TELEMETRY_NAME);
+	xname.data[xname.length++] = channel;
+	xname.data[xname.length++] = c->count;
+	PacketPutFloat(&xname, c->scale);
+	for (i = 0; c->name[i] && xname.length < PACKET_MAX; i++) {
+		xname.data[xname.length++] = c->name[i];
+	}
+	if (!PacketSend(port, &xname)) {
+		return 0;
+	}
+	c->announced = 1;
+	c->frames = 0;
+	return 1;
+}
+
+/**
+ * Send the frame TelemetryPut has been filling, and start another. Sending an
+ * empty frame does nothing. Ahead of it go the names of channels not yet
+ * announced (or whose name didn't get out last time), and of those that have
+ * been in TELEMETRY_RENAME frames since theirs was sent.
+ *
+ * @param port The SCI port the radio is on, from SciInit
+ * @return 1 if sent (or queued), 0 if the port's buffer was too full; the
+ * 				frame is emptied either way
+ */
+Uint16 TelemetrySend(SCIPORT* port) {
+	Uint16 i, sent = 1;
+
+	for (i = 0; i < xnchannels; i++) {
+		if (!xchannels[i].announced || xchannels[i].frames >= TELEMETRY_RENAME) {
+			telemetryName(port, i);//if it doesn't fit, the next send tries again
+		}
+	}
+	if (xframe.length) {
+		sent = PacketSend(port, &xframe);
+	}
+	PacketInit(&xframe, TELEMETRY_DATA);
+	return sent;
+}
+
+/**
+ * Send every channel's name now, rather than as TelemetrySend gets round to
+ * it: e.g. when whoever is listening has just started, since until it hears a
+ * channel's name it can't make sense of any frame holding it.
+ *
+ * @param port The SCI port the radio is on, from SciInit
+ * @return 1 if all were sent (or queued), 0 if any didn't fit
+ */
+Uint16 TelemetryAnnounce(SCIPORT* port) {
+	Uint16 i, sent = 1;
+
+	for (i = 0; i < xnchannels; i++) {
+		sent &= telemetryName(port, i);
+	}
+	return sent;
+}
+
+/**
+ * The channel with this name and count, named now if it is new. TelemetrySend
+ * announces it. New names are copied into xnames, so unlike TelemetryChannel
+ * this takes any string.
+ */
+static Uint16 telemetryLookup(char* name, Uint16 count) {
+	Uint16 i, length = strlen(name) + 1;
+	char* copy = &xnames[xnamesused];
+
+	for (i = 0; i < xnchannels; i++) {
+		if (xchannels[i].name == name || strcmp(xchannels[i].name, name) == 0) {
+			return (xchannels[i].count == count) ? i : TELEMETRY_NONE;
+		}
+	}
+	//the caller's string may be on its stack, so the channel keeps a copy
+	if (length > TELEMETRY_NAMES - xnamesused) {
+		return TELEMETRY_NONE;
+	}
+	memcpy(copy, name, length);
+	i = TelemetryChannel(copy, TELEMETRY_FLOAT, count);
+	if (i != TELEMETRY_NONE) {
+		xnamesused += length;
+	}
+	return i;
+}
+
+/**
+ * Send a single floating-point number with a description, as a frame of its
+ * own. The description goes separately, as TelemetrySend says.
+ *
+ * @param port The SCI port the radio is on, from SciInit
+ * @param name A string describing the data. It is copied the first time, so
+ * 				it needn't outlive the call.
+ * @param send A float to send
+ * @return 1 if sent (or queued), 0 if not
+ */
+Uint16 sendFloat(SCIPORT* port, char* name, float32 send){
+	return sendFloats(port, name, &send, 1);
+}
+
+/**
+ * Send an array of floating-point numbers, as sendFloat does.
+ *
+ * @param port The SCI port the radio is on, from SciInit
+ * @param name A string describing the data, copied the first time. Use the
+ * 				same len every time.
+ * @param send An array of floats to send as data
+ * @param len The length of the data-array
+ * @return 1 if sent (or queued), 0 if not, or if the channel couldn't be made:
+ * 				TELEMETRY_CHANNELS are named or TELEMETRY_NAMES is used up
+ */
+Uint16 sendFloats(SCIPORT* port, char* name, float32* send, Uint16 len) {
+	Uint16 channel = telemetryLookup(name, len);
+
+	if (channel == TELEMETRY_NONE) {
+		return 0;
+	}
+	if (!TelemetryPut(channel, send)) {
+		TelemetrySend(port);//make room
+		TelemetryPut(channel, send);
+	}
+	return TelemetrySend(port);
+}
@@ -1,12 +1,27 @@
-/**
- *  Created on: Nov 20, 2013
- *  Updated on: 17 Jan 2015
- *
- * @author Pavel Komarov <pkomarov@gatech.edu> 941-545-7573
- * @author Andrey Kurenkov <andrey.sendme@gmail.com>
- */
-
-void sendFloat(char, char*, float32);
-void sendFloats(char, char*, float32*, Uint16);
-//no recieve functionality necessary right now.
-
+/**
+ *  Created on: Nov 20, 2013
+ *  Updated on: 17 Jan 2015
+ *
+ * @author Pavel Komarov <pkomarov@gatech.edu> 941-545-7573
+ * @author Andrey Kurenkov <andrey.sendme@gmail.com>
+ */
+
+#include "sci.h"
+#include "packet.h"
+
+#define TELEMETRY_CHANNELS 32//most channels that can be named
+#define TELEMETRY_NONE 0xFFFF//what TelemetryChannel gives when it can't make one
+#define TELEMETRY_NAMES 256//characters kept for names sendFloat copies
+#define TELEMETRY_RENAME 50//frames a channel is sent in before its name is sent again
+#define TELEMETRY_FLOAT 0//scale for a channel sent as float32 rather than int16
+#define TELEMETRY_DATA 'T'//packet type of a frame of values
+#define TELEMETRY_NAME 'N'//packet type of a channel's description
+
+Uint16 TelemetryChannel(char* name, float32 scale, Uint16 count);
+Uint16 TelemetryPut(Uint16 channel, float32* values);
+Uint16 TelemetrySend(SCIPORT* port);
+Uint16 TelemetryAnnounce(SCIPORT* port);
+
+Uint16 sendFloat(SCIPORT*, char*, float32);
+Uint16 sendFloats(SCIPORT*, char*, float32*, Uint16);
+//no recieve functionality necessary right now.
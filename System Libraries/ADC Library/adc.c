@@ -38,6 +38,11 @@
  * the ADC side and the PIE-vector-table side.
  *
  *
+ * For fast sampling, an interrupt per conversion is too expensive. The
+ * AdcStream functions hand a block of socs off to DMA channel 1, which fills
+ * a ping-pong buffer so the CPU only wakes once per half-buffer.
+ *
+ *
  * Note that ADC pins can be made digital I/Os (like GPIO) with
  * GpioCtrlRegs.AIOMUX1.bit.AIO2 = 0; But there are so many digital
  * GPIOs you will probably never need to do this.
@@ -45,8 +50,26 @@
 
 #include "F2806x_Device.h"
 #include "F2806x_usDelay.h"
+#include "F2806x_GlobalPrototypes.h"
+#include "F2806x_Dma_defines.h"
 #include "adc.h"
 
+int32 xgain[16];//per-channel Q24 multiplier per count, set with AdcSetScale
+int32 xoff[16];//per-channel Q16 offset
+Uint16 xactive;//bitmask of socs that have been set up
+
+typedef struct {//everything AdcOffsetSelfCal and AdcAverage stomp on
+	Uint16 socctl[16];
+	Uint16 intsel[5];
+	Uint16 intsocsel1, intsocsel2;
+	Uint16 samplemode;//SIMULEN bits of any AdcSetupPair pairs
+} ADCSAVE;
+
+Uint16* xstreambuf;//the ping-pong buffer handed to AdcStreamInit
+Uint16 xstreamlen;//length of one half of that buffer
+Uint16 xstreamnext;//which half (0 or 1) the DMA will fill on its next transfer
+Uint16 xstreamcnt;//number of transfers begun since AdcStreamStart
+
 /**
  * Power on all the necessities of the ADC module. This stuff is common
  * to all soc-units.
@@ -67,11 +90,18 @@ void AdcInit() {
 	AdcRegs.ADCCTL2.bit.ADCNONOVERLAP = 1;//"Overlap of sample is not allowed"
 	AdcRegs.ADCCTL2.bit.CLKDIV2EN = 1;//set fadc = fclk/4 by default
 	AdcRegs.ADCCTL2.bit.CLKDIV4EN = 1;
+
+	Uint16 i;
+	for (i = 0; i < 16; i++) {//by default AdcScaled returns Volts
+		AdcSetScale((CHANNEL)i, 1.0, 0.0);
+	}
+	xactive = 0;
 }
 
 /**
  * Sets fadc to be either fclk, fclk/2, or fclk/4. Note that the init() function
- * sets the clock speed to be fclk/4 (slow) by default to save power.
+ * sets the clock speed to be fclk/4 (slow) by default to save power. See also
+ * AdcSetFastestClock.
  *
  * @param div A DIVISOR enum describing the magnitude fadc/fclck
  */
@@ -92,6 +122,123 @@ void AdcSetClock(DIVISOR div) {
 	}
 }
 
+/**
+ * Timing. Every soc spends ACQPS+1 ADC clocks sampling, then 13 converting.
+ * The sample window has to be long enough for the ADC's sampling capacitor to
+ * charge through the source impedance; a low-impedance source (an op-amp
+ * output) is happy with the minimum of 7, but a big resistor divider is not.
+ * Rather than take the slowest setting everywhere, work out each channel's
+ * window with AdcMinAcqps, set it with AdcSetAcqps, run the ADC clock as fast
+ * as it will go with AdcSetFastestClock, and check the result with AdcMaxRate.
+ *
+ * Like SetSciBaudRate in the SCI Library, these take fclk in MHz as a
+ * parameter; get it from getfclk in the Clock Library.
+ */
+
+/**
+ * @return fclk/fadc as currently set
+ */
+Uint16 AdcClockDivisor() {
+	if (AdcRegs.ADCCTL2.bit.CLKDIV2EN) {
+		return (AdcRegs.ADCCTL2.bit.CLKDIV4EN) ? 4 : 2;
+	}
+	return 1;
+}
+
+/**
+ * Run the ADC clock as fast as the datasheet allows (45MHz at most).
+ *
+ * @param fclk The system clock frequency in MHz
+ */
+void AdcSetFastestClock(float32 fclk) {
+	if (fclk <= 45.0) {
+		AdcSetClock(WHOLE);
+	} else if (fclk <= 90.0) {
+		AdcSetClock(HALF);
+	} else {
+		AdcSetClock(FOURTH);
+	}
+}
+
+/**
+ * Find the shortest sample window that lets the input settle to within half
+ * an LSB. The sampling capacitor (1.6pF) charges through the switch (3.4k) and
+ * the source; the pin's own capacitance (5pF) charges through the source alone.
+ * Half an LSB of 12 bits takes ln(2^13) = 9 time constants. Uses the ADC clock
+ * as currently set, so set that first.
+ *
+ * @param fclk The system clock frequency in MHz
+ * @param rs The source impedance in Ohms
+ * @return The ACQPS to use, at least 6. 63 is the most the hardware allows; if
+ * 				even that is too short, slow the ADC clock or buffer the source.
+ */
+Uint16 AdcMinAcqps(float32 fclk, float32 rs) {
+	float32 tau = (rs + 3400.0)*1.6e-12 + rs*5.0e-12;//seconds
+	float32 fadc = fclk*1.0e6/AdcClockDivisor();//Hz
+	float32 window = 9.01*tau*fadc;//ADC clocks
+	Uint16 acqps = (Uint16)window;//truncating leaves acqps+1 >= window
+
+	if (acqps < 6) {
+		return 6;
+	}
+	return (acqps > 63) ? 63 : acqps;
+}
+
+Uint16 AdcClampAcqps(Uint16 acqps) {//into 6 to 63: ACQPS is 6 bits, and under 6 is illegal
+	return (acqps < 6) ? 6 : (acqps > 63) ? 63 : acqps;
+}
+
+/**
+ * Change a soc's sample window without touching its channel or trigger.
+ *
+ * @param soc The soc in question
+ * @param acqps The sample window minus one, in ADC clocks. 6 to 63; anything
+ * 				outside that is clamped to it.
+ */
+void AdcSetAcqps(SOC soc, Uint16 acqps) {
+	ADCSOCCTL(soc).bit.ACQPS = AdcClampAcqps(acqps);
+}
+
+/**
+ * @param acqps The soc's ACQPS setting
+ * @return How many SYSCLK cycles one conversion takes at the current ADC clock
+ */
+Uint32 AdcSocCycles(Uint16 acqps) {
+	return (Uint32)(acqps + 1 + 13)*AdcClockDivisor();
+}
+
+/**
+ * How fast can a set of socs go? The ADC converts one soc at a time, so the
+ * fastest the whole set can be retriggered is once per sum of their conversion
+ * times.
+ *
+ * @param fclk The system clock frequency in MHz
+ * @param socs A bitmask of socs (bit n for SOCn), e.g. 0x0007 for SOC0-2
+ * @return The most conversions per second, summed across the set, in kHz
+ */
+float32 AdcMaxRate(float32 fclk, Uint16 socs) {
+	Uint32 cycles = 0;
+	Uint16 soc, n = 0;
+	for (soc = 0; soc < 16; soc++) {
+		if (socs & (1 << soc)) {
+			cycles += AdcSocCycles(ADCSOCCTL(soc).bit.ACQPS);
+			n++;
+		}
+	}
+	if (cycles == 0) {
+		return 0;
+	}
+	return fclk*1000.0*n/cycles;//x1000 to put MHz in kHz
+}
+
+/**
+ * The soc control registers, the result registers, and the interrupt select
+ * registers all sit next to each other in memory, in order. So rather than
+ * switch on which one we mean, index straight into them. ADCSOCCTL and
+ * ADCRESULT (in adc.h) do the same for the user.
+ */
+#define ADCINTSEL ((volatile Uint16*)&AdcRegs.INTSEL1N2)//INTSEL1N2 through INTSEL9N10
+
 /**
  * Set up the channel to which an soc is connected as well as
  * which event will trigger it.
@@ -101,87 +248,30 @@ void AdcSetClock(DIVISOR div) {
  * @param trig An enum specifying the even that begins the soc
  */
 void AdcSetupSOC(SOC soc, CHANNEL chan, TRIGGER trig) {
-	switch (soc) {
-		case SOC0:
-			AdcRegs.ADCSOC0CTL.bit.CHSEL = chan;//Set socx to listen to ADCINyx
-			AdcRegs.ADCSOC0CTL.bit.TRIGSEL = trig;//Set soc to occur upon event
-			AdcRegs.ADCSOC0CTL.bit.ACQPS = 6;//"Sample window is 7 cycles long" (as brief as possible)
-			break;
-		case SOC1:
-			AdcRegs.ADCSOC1CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC1CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC1CTL.bit.ACQPS = 6;
-			break;
-		case SOC2:
-			AdcRegs.ADCSOC2CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC2CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC2CTL.bit.ACQPS = 6;
-			break;
-		case SOC3:
-			AdcRegs.ADCSOC3CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC3CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC3CTL.bit.ACQPS = 6;
-			break;
-		case SOC4:
-			AdcRegs.ADCSOC4CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC4CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC4CTL.bit.ACQPS = 6;
-			break;
-		case SOC5:
-			AdcRegs.ADCSOC5CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC5CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC5CTL.bit.ACQPS = 6;
-			break;
-		case SOC6:
-			AdcRegs.ADCSOC6CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC6CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC6CTL.bit.ACQPS = 6;
-			break;
-		case SOC7:
-			AdcRegs.ADCSOC7CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC7CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC7CTL.bit.ACQPS = 6;
-			break;
-		case SOC8:
-			AdcRegs.ADCSOC8CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC8CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC8CTL.bit.ACQPS = 6;
-			break;
-		case SOC9:
-			AdcRegs.ADCSOC9CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC9CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC9CTL.bit.ACQPS = 6;
-			break;
-		case SOC10:
-			AdcRegs.ADCSOC10CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC10CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC10CTL.bit.ACQPS = 6;
-			break;
-		case SOC11:
-			AdcRegs.ADCSOC11CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC11CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC11CTL.bit.ACQPS = 6;
-			break;
-		case SOC12:
-			AdcRegs.ADCSOC12CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC12CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC12CTL.bit.ACQPS = 6;
-			break;
-		case SOC13:
-			AdcRegs.ADCSOC13CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC13CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC13CTL.bit.ACQPS = 6;
-			break;
-		case SOC14:
-			AdcRegs.ADCSOC14CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC14CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC14CTL.bit.ACQPS = 6;
-			break;
-		case SOC15:
-			AdcRegs.ADCSOC15CTL.bit.CHSEL = chan;
-			AdcRegs.ADCSOC15CTL.bit.TRIGSEL = trig;
-			AdcRegs.ADCSOC15CTL.bit.ACQPS = 6;
-			break;
+	//listen to chan, begin upon trig, and "Sample window is 7 cycles long" (as brief as possible)
+	ADCSOCCTL(soc).all = ((Uint16)trig << 11) | ((Uint16)chan << 6) | 6;
+	xactive |= 1 << soc;
+}
+
+/**
+ * Set up a whole sequence of socs in one pass. Each entry of the table is
+ * written to its soc's control register in a single store.
+ *
+ * Example:
+ * SOCSETUP phases[3] = {{SOC0, ADCA0, PWM1A, 6},
+ * 						 {SOC1, ADCA1, PWM1A, 6},
+ * 						 {SOC2, ADCB1, PWM1A, 6}};
+ * AdcSetupSOCs(phases, 3);
+ *
+ * @param table An array of SOCSETUPs
+ * @param len The length of the table
+ */
+void AdcSetupSOCs(SOCSETUP* table, Uint16 len) {
+	Uint16 i;
+	for (i = 0; i < len; i++) {
+		ADCSOCCTL(table[i].soc).all = ((Uint16)table[i].trig << 11)
+				| ((Uint16)table[i].chan << 6) | AdcClampAcqps(table[i].acqps);
+		xactive |= 1 << table[i].soc;
 	}
 }
 
@@ -197,44 +287,13 @@ void AdcSetupSOC(SOC soc, CHANNEL chan, TRIGGER trig) {
  * @param intrpt The ADCINTx you want the soc to throw
  */
 void AdcEnableIsr(SOC soc, INTRPT type) {
-	switch (type) {
-		case ADCINT1:
-			AdcRegs.INTSEL1N2.bit.INT1SEL = soc;//set socx to throw to interrupt to ADCINTy
-			AdcRegs.INTSEL1N2.bit.INT1E = 1;//at its EOC (End Of Conversion)
-			break;
-		case ADCINT2:
-			AdcRegs.INTSEL1N2.bit.INT2SEL = soc;
-			AdcRegs.INTSEL1N2.bit.INT2E = 1;//Enable interrupt from ADCINTy
-			break;
-		case ADCINT3:
-			AdcRegs.INTSEL3N4.bit.INT3SEL = soc;
-			AdcRegs.INTSEL3N4.bit.INT3E = 1;
-			break;
-		case ADCINT4:
-			AdcRegs.INTSEL3N4.bit.INT4SEL = soc;
-			AdcRegs.INTSEL3N4.bit.INT4E = 1;
-			break;
-		case ADCINT5:
-			AdcRegs.INTSEL5N6.bit.INT5SEL = soc;
-			AdcRegs.INTSEL5N6.bit.INT5E = 1;
-			break;
-		case ADCINT6:
-			AdcRegs.INTSEL5N6.bit.INT6SEL = soc;
-			AdcRegs.INTSEL5N6.bit.INT6E = 1;
-			break;
-		case ADCINT7:
-			AdcRegs.INTSEL7N8.bit.INT7SEL = soc;
-			AdcRegs.INTSEL7N8.bit.INT7E = 1;
-			break;
-		case ADCINT8:
-			AdcRegs.INTSEL7N8.bit.INT8SEL = soc;
-			AdcRegs.INTSEL7N8.bit.INT8E = 1;
-			break;
-		case ADCINT9:
-			AdcRegs.INTSEL9N10.bit.INT9SEL = soc;
-			AdcRegs.INTSEL9N10.bit.INT9E = 1;
-			break;
+	if (type < ADCINT1 || type > ADCINT9) {
+		return;
 	}
+	Uint16 n = type - ADCINT1;//ADCINT1 and 2 share a register, 3 and 4 share the next, ...
+	Uint16 shift = (n & 1) << 3;//odd ADCINTs in the low byte, even in the high
+	ADCINTSEL[n >> 1] = (ADCINTSEL[n >> 1] & ~(0x3F << shift))//keep the CONT bit
+			| ((0x20 | (Uint16)soc) << shift);//set socx to throw ADCINTy at its EOC, and enable
 }
 
 /**
@@ -245,101 +304,680 @@ void AdcEnableIsr(SOC soc, INTRPT type) {
  * @param soc An soc denoting which system should be directed to begin a measurement
  */
 void AdcStartMeas(SOC soc) {
-	switch (soc) {
-		case SOC0:
-			AdcRegs.ADCSOCFRC1.bit.SOC0 = 1;
-			break;
-		case SOC1:
-			AdcRegs.ADCSOCFRC1.bit.SOC1 = 1;
-			break;
-		case SOC2:
-			AdcRegs.ADCSOCFRC1.bit.SOC2 = 1;
-			break;
-		case SOC3:
-			AdcRegs.ADCSOCFRC1.bit.SOC3 = 1;
-			break;
-		case SOC4:
-			AdcRegs.ADCSOCFRC1.bit.SOC4 = 1;
-			break;
-		case SOC5:
-			AdcRegs.ADCSOCFRC1.bit.SOC5 = 1;
-			break;
-		case SOC6:
-			AdcRegs.ADCSOCFRC1.bit.SOC6 = 1;
-			break;
-		case SOC7:
-			AdcRegs.ADCSOCFRC1.bit.SOC7 = 1;
-			break;
-		case SOC8:
-			AdcRegs.ADCSOCFRC1.bit.SOC8 = 1;
-			break;
-		case SOC9:
-			AdcRegs.ADCSOCFRC1.bit.SOC9 = 1;
-			break;
-		case SOC10:
-			AdcRegs.ADCSOCFRC1.bit.SOC10 = 1;
-			break;
-		case SOC11:
-			AdcRegs.ADCSOCFRC1.bit.SOC11 = 1;
-			break;
-		case SOC12:
-			AdcRegs.ADCSOCFRC1.bit.SOC12 = 1;
+	AdcRegs.ADCSOCFRC1.all = 1 << soc;//writing 0s to the other bits has no effect
+}
+
+/**
+ * Read a result in Volts. Performs conversion from [0, 4095]
+ * to [0.0, 3.3] V.
+ *
+ * @param soc An SOC denoting which system did the conversion
+ */
+float32 AdcRes(SOC soc) {
+	return 3.3*ADCRESULT(soc)/4095;
+}
+
+/**
+ * The rest of these read functions avoid floating point entirely, so they
+ * are cheap enough to call from any ISR.
+ *
+ * @param soc An SOC denoting which system did the conversion
+ * @return The raw result in [0, 4095]
+ */
+Uint16 AdcRaw(SOC soc) {
+	return ADCRESULT(soc);
+}
+
+/**
+ * @param soc An SOC denoting which system did the conversion
+ * @return The result in mV, [0, 3300]. 52816 is 3300/4095 in Q16.
+ */
+Uint16 AdcMillivolts(SOC soc) {
+	return ((Uint32)ADCRESULT(soc)*52816) >> 16;
+}
+
+/**
+ * @param soc An SOC denoting which system did the conversion
+ * @return The result as a Q15 fraction of full scale, [0, 32767]. The top
+ * 				bits are copied into the bottom so that 4095 maps to 32767.
+ */
+Uint16 AdcQ15(SOC soc) {
+	Uint16 r = ADCRESULT(soc);
+	return (r << 3) | (r >> 9);
+}
+
+/**
+ * Describe the interface circuit between a channel and whatever it is
+ * measuring, so that AdcScaled can return engineering units (Amps, degrees,
+ * whatever). The engineering value is gain*V + offset, where V is the pin
+ * voltage in Volts. For example, the 4550 current sensor from the top of this
+ * file would be AdcSetScale(ADCA0, 6.060727, -9.93964).
+ *
+ * The floating-point math happens here, once, so call this at init. The
+ * result is kept as a Q24 multiplier per count.
+ *
+ * @param chan The channel (pin) the circuit is attached to
+ * @param gain Engineering units per Volt at the pin
+ * @param offset Engineering units at 0V
+ */
+void AdcSetScale(CHANNEL chan, float32 gain, float32 offset) {
+	xgain[chan] = (int32)(gain*3.3/4095*16777216.0);//2^24
+	xoff[chan] = (int32)(offset*65536.0);//2^16
+}
+
+/**
+ * Read a result in the units set with AdcSetScale, in Q16 (so 1.5A is 98304).
+ * Compare against constants built with ADC_Q16 in adc.h. With no AdcSetScale
+ * call, the units are Volts. The odd soc of an AdcSetupPair pair holds the B
+ * channel's result, and is scaled as that channel.
+ *
+ * @param soc An SOC denoting which system did the conversion
+ * @return The scaled result in Q16
+ */
+int32 AdcScaled(SOC soc) {
+	Uint16 chan = ADCSOCCTL(soc).bit.CHSEL;
+	if ((soc & 1) && (AdcRegs.ADCSAMPLEMODE.all & (1 << (soc >> 1)))) {
+		chan = (chan & 7) + 8;//CHSEL names the pair; the odd soc converts its B side
+	}
+	return (int32)(((int64)ADCRESULT(soc)*xgain[chan]) >> 8) + xoff[chan];
+}
+
+/**
+ * Read every soc that has been set up with AdcSetupSOC or AdcSetupSOCs,
+ * lowest soc first, and scale each as AdcScaled would.
+ *
+ * @param out An array of at least as many int32s as there are active socs
+ * @return The number of results written to out
+ */
+Uint16 AdcScaledAll(int32* out) {
+	Uint16 soc, n = 0;
+	for (soc = 0; soc < 16; soc++) {
+		if (xactive & (1 << soc)) {
+			out[n++] = AdcScaled((SOC)soc);
+		}
+	}
+	return n;
+}
+
+/**
+ * Simultaneous sampling. The ADC has two sample-and-holds, one for the A
+ * channels and one for the B channels, so ADCAx and ADCBx can be sampled at
+ * the same instant and then converted one after the other. Field-oriented
+ * motor control wants exactly this for two phase currents: sampled
+ * sequentially, the second lags the first by a whole conversion.
+ *
+ * A pair occupies an even soc and the odd soc after it. The A result lands
+ * in the even result register and the B result in the odd one, so both come
+ * back in one 32-bit read.
+ */
+
+/**
+ * @param soc An even soc (SOC0, SOC2, ..., SOC14). It and the one after it are used.
+ * @param chan One of ADCA0-ADCA7 (or ADCB0-ADCB7; same pair). Its partner on
+ * 				the other side is sampled with it.
+ * @param trig An enum specifying the event that begins the conversion of both
+ */
+void AdcSetupPair(SOC soc, CHANNEL chan, TRIGGER trig) {
+	Uint16 even = soc & ~1;
+	Uint16 ctl = ((Uint16)trig << 11) | (((Uint16)chan & 7) << 6) | 6;//CHSEL picks the pair
+
+	ADCSOCCTL(even).all = ctl;//the even soc's settings govern the pair
+	ADCSOCCTL(even + 1).all = ctl;//keep the odd one consistent with it
+	AdcRegs.ADCSAMPLEMODE.all |= 1 << (even >> 1);//SIMULEN bit for the pair
+	xactive |= 3 << even;
+}
+
+/**
+ * Put a pair back to sequential sampling. Set the two socs up again afterward.
+ *
+ * @param soc The even soc of the pair
+ */
+void AdcClearPair(SOC soc) {
+	AdcRegs.ADCSAMPLEMODE.all &= ~(1 << (soc >> 1));
+}
+
+/**
+ * Read both halves of a pair at once. Wait for the odd soc's EOC (give it to
+ * AdcEnableIsr) before reading; the B result is latched last.
+ *
+ * @param soc The even soc of the pair
+ * @return The A result in the low 16 bits and the B result in the high 16.
+ * 				Split with ADC_PAIR_A and ADC_PAIR_B.
+ */
+Uint32 AdcPairRaw(SOC soc) {
+	return *(volatile Uint32*)&ADCRESULT(soc & ~1);
+}
+
+/**
+ * Read a pair in engineering units, using the A and B channels' own
+ * AdcSetScale/AdcCalibrate2Point tables.
+ *
+ * @param soc The even soc of the pair
+ * @param a Where to put the A result, in Q16
+ * @param b Where to put the B result, in Q16
+ */
+void AdcPairScaled(SOC soc, int32* a, int32* b) {
+	Uint16 even = soc & ~1;
+	Uint16 chan = ADCSOCCTL(even).bit.CHSEL & 7;
+	Uint32 raw = AdcPairRaw((SOC)even);
+
+	*a = (int32)(((int64)ADC_PAIR_A(raw)*xgain[chan]) >> 8) + xoff[chan];
+	*b = (int32)(((int64)ADC_PAIR_B(raw)*xgain[chan + 8]) >> 8) + xoff[chan + 8];
+}
+
+/**
+ * Calibration. There are two kinds of error to get rid of:
+ *
+ * 1. The ADC core itself has a small offset. TI's AdcOffsetSelfCal (in
+ * F2806x_Adc.c) measures it against VREFLO and trims it out in hardware via
+ * ADCOFFTRIM. AdcCalibrateOffset wraps that so it doesn't wreck your socs.
+ *
+ * 2. The interface circuit on each channel has some gain and offset that never
+ * quite matches the resistor values on the schematic. AdcCalibrate2Point fixes
+ * that from two known inputs, and the result goes straight into the tables
+ * AdcScaled uses, so nothing costs more at run time than it did before.
+ *
+ * Once a board has been calibrated, AdcGetCal dumps everything into an ADCCAL
+ * which can be printed, pasted into the project as a const, and loaded at boot
+ * with AdcLoadCal.
+ */
+
+void AdcSave(ADCSAVE* save) {
+	Uint16 i;
+	for (i = 0; i < 16; i++) {
+		save->socctl[i] = ADCSOCCTL(i).all;
+	}
+	for (i = 0; i < 5; i++) {
+		save->intsel[i] = ADCINTSEL[i];
+	}
+	save->intsocsel1 = AdcRegs.ADCINTSOCSEL1.all;
+	save->intsocsel2 = AdcRegs.ADCINTSOCSEL2.all;
+	save->samplemode = AdcRegs.ADCSAMPLEMODE.all;
+}
+
+void AdcRestore(ADCSAVE* save) {
+	Uint16 i;
+	AdcRegs.ADCINTSOCSEL1.all = save->intsocsel1;//stop anything still ping-ponging first
+	AdcRegs.ADCINTSOCSEL2.all = save->intsocsel2;
+	for (i = 0; i < 16; i++) {
+		ADCSOCCTL(i).all = save->socctl[i];
+	}
+	AdcRegs.ADCSAMPLEMODE.all = save->samplemode;
+	for (i = 0; i < 5; i++) {
+		ADCINTSEL[i] = save->intsel[i];
+	}
+	AdcRegs.ADCINTFLGCLR.all = 0x01FF;//throw away flags raised along the way
+	AdcRegs.ADCINTOVFCLR.all = 0x01FF;
+}
+
+/**
+ * Trim out the ADC core offset. Call after AdcInit with the ADC clock at the
+ * speed it will run at. Soc setup is saved and restored around TI's routine,
+ * which otherwise reassigns every soc. Any simultaneous pairs are made
+ * sequential while it runs, since it expects to convert one channel at a time.
+ * Takes a few ms.
+ */
+void AdcCalibrateOffset() {
+	ADCSAVE save;
+	AdcSave(&save);
+	AdcRegs.ADCSAMPLEMODE.all = 0;
+	AdcOffsetSelfCal();
+	EALLOW;//TI's routine ends with EDIS, but we (and likely the caller) still need access
+	AdcRestore(&save);
+}
+
+/**
+ * Convert a soc n times from software and average the raw results. Borrows
+ * ADCINT9 to know when each conversion is done, and puts it back afterward.
+ * Meant for calibration, not for use in a loop.
+ *
+ * @param soc An soc already set up (with AdcSetupSOC) to listen to the channel of interest
+ * @param n The number of conversions to average
+ * @return The average raw result in [0, 4095]
+ */
+Uint16 AdcAverage(SOC soc, Uint16 n) {
+	ADCSAVE save;
+	Uint32 sum = 0;
+	Uint16 i;
+
+	AdcSave(&save);
+	AdcRegs.INTSEL9N10.bit.INT9CONT = 0;
+	AdcEnableIsr(soc, ADCINT9);
+	AdcRegs.ADCINTFLGCLR.bit.ADCINT9 = 1;
+	for (i = 0; i < n; i++) {
+		AdcStartMeas(soc);
+		while (AdcRegs.ADCINTFLG.bit.ADCINT9 == 0) {}//wait for the EOC
+		AdcRegs.ADCINTFLGCLR.bit.ADCINT9 = 1;
+		sum += ADCRESULT(soc);
+	}
+	AdcRestore(&save);
+	return (sum + n/2)/n;//rounded
+}
+
+/**
+ * Work out a channel's gain and offset from two known inputs and load them
+ * into the AdcScaled tables. For example, for a current sensor: run 0A through
+ * it and take raw1 = AdcAverage(SOC0, 256), then run 20A and take raw2 the
+ * same way, then AdcCalibrate2Point(ADCA0, raw1, 0.0, raw2, 20.0).
+ *
+ * @param chan The channel being calibrated
+ * @param raw1 The raw result at the first known input
+ * @param eng1 The first known input, in engineering units
+ * @param raw2 The raw result at the second known input. Must differ from raw1.
+ * @param eng2 The second known input, in engineering units
+ */
+void AdcCalibrate2Point(CHANNEL chan, Uint16 raw1, float32 eng1, Uint16 raw2, float32 eng2) {
+	if (raw1 == raw2) {
+		return;//no slope to be had
+	}
+	float32 perCount = (eng2 - eng1)/((float32)raw2 - (float32)raw1);
+	xgain[chan] = (int32)(perCount*16777216.0);//2^24
+	xoff[chan] = (int32)((eng1 - perCount*raw1)*65536.0);//2^16
+}
+
+/**
+ * @param cal An ADCCAL to be filled with the current ADCOFFTRIM and scale tables
+ */
+void AdcGetCal(ADCCAL* cal) {
+	Uint16 i;
+	cal->offtrim = AdcRegs.ADCOFFTRIM.all;
+	for (i = 0; i < 16; i++) {
+		cal->gain[i] = xgain[i];
+		cal->offset[i] = xoff[i];
+	}
+}
+
+/**
+ * Apply a calibration saved earlier with AdcGetCal. Call after AdcInit, which
+ * would otherwise reset the scale tables to Volts.
+ *
+ * @param cal A stored calibration
+ */
+void AdcLoadCal(const ADCCAL* cal) {
+	Uint16 i;
+	AdcRegs.ADCOFFTRIM.all = cal->offtrim;
+	for (i = 0; i < 16; i++) {
+		xgain[i] = cal->gain[i];
+		xoff[i] = cal->offset[i];
+	}
+}
+
+/**
+ * Oversampling. Point n socs at the same channel with the same trigger and the
+ * ADC will convert it n times back-to-back (round-robin goes in soc order).
+ * Summing the n results and shifting gives extra bits of resolution: every 4x
+ * oversampling buys one bit, provided there is a little noise to dither with,
+ * which there always is. 16 socs gives 14 bits.
+ *
+ * The averaging that used to happen in a loop inside adcISR is then one sum
+ * over adjacent result registers.
+ */
+
+Uint16 AdcLog2(Uint16 n) {//for powers of 2
+	Uint16 k = 0;
+	while (n >>= 1) {
+		k++;
+	}
+	return k;
+}
+
+/**
+ * @param os An ADCOVERSAMPLE to describe this group of socs
+ * @param first The first soc in the group
+ * @param n How many socs, starting at first, to use: 4 or 16 for 1 or 2 extra bits
+ * 				(2 and 8 work too, but waste half their samples)
+ * @param chan The channel to oversample
+ * @param trig The event that starts all n conversions
+ */
+void AdcOversampleInit(ADCOVERSAMPLE* os, SOC first, Uint16 n, CHANNEL chan, TRIGGER trig) {
+	Uint16 i;
+	Uint16 k = AdcLog2(n);
+
+	os->first = first;
+	os->n = n;
+	os->bits = 12 + k/2;
+	os->shift = k - k/2;//sum has 12+k bits; keep 12+k/2 of them
+
+	for (i = 0; i < n; i++) {
+		AdcSetupSOC((SOC)(first + i), chan, trig);
+	}
+}
+
+/**
+ * Call once the last soc in the group has converted (e.g. from the ADCINT it
+ * throws; see AdcEnableIsr).
+ *
+ * @param os A group set up with AdcOversampleInit
+ * @return The oversampled result, os->bits wide
+ */
+Uint16 AdcOversampled(ADCOVERSAMPLE* os) {
+	volatile Uint16* r = &ADCRESULT(os->first);
+	Uint32 sum = 0;
+	Uint16 i;
+	for (i = 0; i < os->n; i++) {
+		sum += r[i];
+	}
+	return sum >> os->shift;
+}
+
+/**
+ * Decimation. For slow things like pack voltage and temperature, feed every
+ * (oversampled) result through a CIC filter and only look at every ratio-th
+ * output. Order 1 is a plain boxcar average; higher orders roll off aliases
+ * harder at the cost of a longer step response. The integrators are allowed
+ * to wrap: CIC math comes out right modulo 2^32 anyway, as long as
+ * input bits + order*AdcLog2(ratio) <= 32.
+ *
+ * @param d An ADCDECIMATOR to initialize
+ * @param order 1 (boxcar) to 3
+ * @param ratio The decimation ratio. Must be a power of 2.
+ */
+void AdcDecimatorInit(ADCDECIMATOR* d, Uint16 order, Uint16 ratio) {
+	Uint16 i;
+	d->order = (order < 1) ? 1 : (order > 3) ? 3 : order;
+	d->ratio = ratio;
+	d->shift = d->order*AdcLog2(ratio);//the gain of a CIC is ratio^order
+	d->count = 0;
+	d->out = 0;
+	for (i = 0; i < 3; i++) {
+		d->integ[i] = 0;
+		d->comb[i] = 0;
+	}
+}
+
+/**
+ * @param d A decimator set up with AdcDecimatorInit
+ * @param in The next input sample
+ * @return 1 if a new output is waiting in d->out, 0 otherwise
+ */
+Uint16 AdcDecimate(ADCDECIMATOR* d, Uint16 in) {
+	Uint16 i;
+	Uint32 x, y;
+
+	d->integ[0] += in;//integrators run at the input rate
+	for (i = 1; i < d->order; i++) {
+		d->integ[i] += d->integ[i-1];
+	}
+
+	if (++d->count < d->ratio) {
+		return 0;
+	}
+	d->count = 0;
+
+	x = d->integ[d->order-1];//combs run at the output rate
+	for (i = 0; i < d->order; i++) {
+		y = x - d->comb[i];
+		d->comb[i] = x;
+		x = y;
+	}
+	d->out = x >> d->shift;
+	return 1;
+}
+
+/**
+ * PWM-synchronized sampling. Rather than start conversions from a timer ISR,
+ * let an ePWM module start them at a fixed point in its period (the valley,
+ * say, when the low-side switches are on and the phase current is clean).
+ * The CPU is not involved at all until results are ready.
+ *
+ * Each ePWM module has two start-of-conversion outputs, SOCA and SOCB, so one
+ * module can serve two distinct (event, every) combinations. AdcSchedule takes
+ * a list of samples wanted, groups them onto SOCA and SOCB, assigns free socs,
+ * programs ETSEL/ETPS, and checks that each group finishes converting before
+ * the next group is triggered.
+ */
+
+volatile struct EPWM_REGS* xepwm[8] = {&EPwm1Regs, &EPwm2Regs, &EPwm3Regs, &EPwm4Regs,
+									   &EPwm5Regs, &EPwm6Regs, &EPwm7Regs, &EPwm8Regs};
+
+/**
+ * @param pwm The ePWM module
+ * @param event When in its period
+ * @return Where event happens, in TBCLKs from the start of the period, or
+ * 				0xFFFFFFFF if it never happens in the module's count mode
+ */
+Uint32 AdcEventTime(volatile struct EPWM_REGS* pwm, PWMEVENT event) {
+	Uint16 mode = pwm->TBCTL.bit.CTRMODE;
+	Uint32 prd = pwm->TBPRD;
+	Uint32 c;
+
+	switch (event) {
+		case CMPAUP:
+		case CMPADOWN:
+			c = pwm->CMPA.half.CMPA;
 			break;
-		case SOC13:
-			AdcRegs.ADCSOCFRC1.bit.SOC13 = 1;
+		case CMPBUP:
+		case CMPBDOWN:
+			c = pwm->CMPB;
 			break;
-		case SOC14:
-			AdcRegs.ADCSOCFRC1.bit.SOC14 = 1;
+		case PEAK:
+			c = prd;
 			break;
-		case SOC15:
-			AdcRegs.ADCSOCFRC1.bit.SOC15 = 1;
+		default:
+			c = 0;
 			break;
 	}
+
+	if (mode == 0) {//up count: 0 to TBPRD
+		return (event == CMPADOWN || event == CMPBDOWN) ? 0xFFFFFFFF : c;
+	} else if (mode == 1) {//down count: TBPRD to 0
+		return (event == CMPAUP || event == CMPBUP) ? 0xFFFFFFFF : prd - c;
+	} else {//up-down count: 0 up to TBPRD and back down
+		return (event == CMPADOWN || event == CMPBDOWN) ? 2*prd - c : c;
+	}
 }
 
+/**
+ * Example, sampling two phase currents in the valley of every period of ePWM1
+ * and the bus voltage at the peak of every third:
+ *
+ * ADCSAMPLE samples[3] = {{ADCA0, VALLEY, 1, 6},
+ * 						   {ADCB0, VALLEY, 1, 6},
+ * 						   {ADCA3, PEAK, 3, 6}};
+ * if (!AdcSchedule(1, samples, 3)) {//doesn't fit}
+ * //samples[i].soc now says which soc's result to read
+ *
+ * Set up the ePWM's period and count mode first, since the check depends on
+ * them. The check assumes both groups can fire in the same period, which is
+ * conservative when their every differs. Groups whose events fall at the same
+ * time (the same event with two different everys, say) are checked as one burst.
+ *
+ * @param pwm Which ePWM module (1 to 8) starts the conversions
+ * @param reqs The samples wanted. The soc field of each is filled in.
+ * @param len The length of reqs
+ * @return 1 if everything was scheduled and fits, 0 otherwise (nothing is
+ * 				written to the ADC or ePWM in that case)
+ */
+Uint16 AdcSchedule(Uint16 pwm, ADCSAMPLE* reqs, Uint16 len) {
+	volatile struct EPWM_REGS* regs;
+	PWMEVENT event[2];
+	Uint16 every[2];
+	Uint32 cycles[2] = {0, 0};//conversion time of each group in SYSCLKs
+	Uint16 ngroups = 0;
+	Uint16 group[16];
+	Uint16 i, g;
+
+	if (pwm < 1 || pwm > 8 || len == 0 || len > 16) {
+		return 0;
+	}
+	regs = xepwm[pwm-1];
+
+	//group the requests by (event, every): one group per SOCA/SOCB
+	for (i = 0; i < len; i++) {
+		if (reqs[i].every < 1 || reqs[i].every > 3) {
+			return 0;//the ETPS prescaler only counts to 3
+		}
+		for (g = 0; g < ngroups; g++) {
+			if (event[g] == reqs[i].event && every[g] == reqs[i].every) {
+				break;
+			}
+		}
+		if (g == ngroups) {
+			if (ngroups == 2) {
+				return 0;//out of SOC outputs on this module
+			}
+			event[g] = reqs[i].event;
+			every[g] = reqs[i].every;
+			ngroups++;
+		}
+		group[i] = g;
+		cycles[g] += AdcSocCycles(AdcClampAcqps(reqs[i].acqps));
+	}
+
+	//lay every trigger out on the period and check each burst ends before the next begins
+	Uint16 mode = regs->TBCTL.bit.CTRMODE;
+	Uint16 hsp = regs->TBCTL.bit.HSPCLKDIV;
+	Uint32 tbdiv = ((hsp == 0) ? 1 : 2*hsp) << regs->TBCTL.bit.CLKDIV;//SYSCLKs per TBCLK
+	Uint32 period = (mode == 2) ? 2*(Uint32)regs->TBPRD : (Uint32)regs->TBPRD + 1;
+	Uint32 when[4], burst[4], t, b;
+	Uint16 n = 0, j;
+
+	for (g = 0; g < ngroups; g++) {
+		if (event[g] == VALLEYANDPEAK) {
+			when[n] = AdcEventTime(regs, VALLEY); burst[n++] = cycles[g];
+			when[n] = AdcEventTime(regs, PEAK); burst[n++] = cycles[g];
+		} else {
+			when[n] = AdcEventTime(regs, event[g]); burst[n++] = cycles[g];
+		}
+	}
+	for (i = 0; i < n; i++) {
+		if (when[i] == 0xFFFFFFFF) {
+			return 0;//event doesn't happen in this count mode
+		}
+		for (j = i; j > 0 && when[j-1] > when[j]; j--) {//insertion sort by time
+			t = when[j]; when[j] = when[j-1]; when[j-1] = t;
+			b = burst[j]; burst[j] = burst[j-1]; burst[j-1] = b;
+		}
+	}
+	for (i = 1, j = 0; i < n; i++) {//triggers at the same time make one burst
+		if (when[i] == when[j]) {
+			burst[j] += burst[i];
+		} else {
+			j++;
+			when[j] = when[i];
+			burst[j] = burst[i];
+		}
+	}
+	n = j + 1;
+	for (i = 0; i < n; i++) {
+		t = (i+1 < n) ? when[i+1] - when[i] : period - when[i] + when[0];//gap to the next trigger
+		if (burst[i] > t*tbdiv) {
+			return 0;
+		}
+	}
+
+	//assign free socs, in request order
+	SOCSETUP setup[16];
+	Uint16 soc = 0;
+	for (i = 0; i < len; i++) {
+		while (soc < 16 && (xactive & (1 << soc))) {
+			soc++;
+		}
+		if (soc == 16) {
+			return 0;//out of socs
+		}
+		reqs[i].soc = (SOC)soc;
+		setup[i].soc = (SOC)soc;
+		setup[i].chan = reqs[i].chan;
+		setup[i].trig = (TRIGGER)(PWM1A + 2*(pwm-1) + group[i]);//PWMxA for group 0, PWMxB for 1
+		setup[i].acqps = reqs[i].acqps;
+		soc++;
+	}
+	AdcSetupSOCs(setup, len);
+
+	//and have the ePWM start them
+	regs->ETSEL.bit.SOCAEN = 0;
+	regs->ETSEL.bit.SOCBEN = 0;
+	regs->ETSEL.bit.SOCASEL = event[0];
+	regs->ETPS.bit.SOCAPRD = every[0];
+	regs->ETCLR.bit.SOCA = 1;
+	regs->ETSEL.bit.SOCAEN = 1;
+	if (ngroups == 2) {
+		regs->ETSEL.bit.SOCBSEL = event[1];
+		regs->ETPS.bit.SOCBPRD = every[1];
+		regs->ETCLR.bit.SOCB = 1;
+		regs->ETSEL.bit.SOCBEN = 1;
+	}
+	return 1;
+}
 
 /**
- * Read a result in Volts. Performs conversion from [0, 4095]
- * to [0.0, 3.3] V.
+ * Streaming mode. Rather than taking an interrupt per conversion, DMA channel 1
+ * copies the results of a block of socs into RAM every time the last soc in the
+ * block throws its ADCINT. The RAM is split into two halves (ping and pong): while
+ * the DMA fills one, the CPU is free to process the other. The CPU only hears about
+ * it once per filled half, via the DMA CH1 interrupt (DMACH1 in the Interrupts Library).
  *
- * @param soc An SOC denoting which system did the conversion
+ * Only ADCINT1 and ADCINT2 can trigger the DMA. The socs should be set up with
+ * AdcSetupSOC first and triggered by something that does not need the CPU, like a
+ * PWM or a CPU timer. Do not register the ADCINT itself with IsrInit; the DMA
+ * eats it. The buffer must live in DMA-accessible RAM (L5-L8), so put it there with
+ * something like #pragma DATA_SECTION(buf, "DMARAML5");
+ *
+ * @param first The first soc in the block
+ * @param last The last soc in the block. Its EOC triggers the DMA.
+ * @param type ADCINT1 or ADCINT2
+ * @param buf A buffer of 2*len words
+ * @param len The length of one half of buf. Must be a multiple of last-first+1.
  */
-float32 AdcRes(SOC soc) {
-	switch (soc) {
-		case SOC0:
-			return 3.3*AdcResult.ADCRESULT0/4095;
-		case SOC1:
-			return 3.3*AdcResult.ADCRESULT1/4095;
-		case SOC2:
-			return 3.3*AdcResult.ADCRESULT2/4095;
-		case SOC3:
-			return 3.3*AdcResult.ADCRESULT3/4095;
-		case SOC4:
-			return 3.3*AdcResult.ADCRESULT4/4095;
-		case SOC5:
-			return 3.3*AdcResult.ADCRESULT5/4095;
-		case SOC6:
-			return 3.3*AdcResult.ADCRESULT6/4095;
-		case SOC7:
-			return 3.3*AdcResult.ADCRESULT7/4095;
-		case SOC8:
-			return 3.3*AdcResult.ADCRESULT8/4095;
-		case SOC9:
-			return 3.3*AdcResult.ADCRESULT9/4095;
-		case SOC10:
-			return 3.3*AdcResult.ADCRESULT10/4095;
-		case SOC11:
-			return 3.3*AdcResult.ADCRESULT11/4095;
-		case SOC12:
-			return 3.3*AdcResult.ADCRESULT12/4095;
-		case SOC13:
-			return 3.3*AdcResult.ADCRESULT13/4095;
-		case SOC14:
-			return 3.3*AdcResult.ADCRESULT14/4096;
-		case SOC15:
-			return 3.3*AdcResult.ADCRESULT15/4095;
-		default:
-			return 0;//to silence a warning
+void AdcStreamInit(SOC first, SOC last, INTRPT type, Uint16* buf, Uint16 len) {
+	Uint16 nsoc = last - first + 1;
+
+	xstreambuf = buf;
+	xstreamlen = len;
+	xstreamnext = 0;
+	xstreamcnt = 0;
+
+	SysCtrlRegs.PCLKCR3.bit.DMAENCLK = 1;//enable the clock to the DMA
+	asm(" NOP"); asm(" NOP");
+
+	AdcEnableIsr(last, type);//the EOC of the last soc in the block throws the ADCINT
+	if (type == ADCINT1) {
+		AdcRegs.INTSEL1N2.bit.INT1CONT = 1;//keep throwing even though nobody clears the flag
+	} else {
+		AdcRegs.INTSEL1N2.bit.INT2CONT = 1;
 	}
+
+	DMAInitialize();
+	DMACH1AddrConfig(buf, &ADCRESULT(first));
+	DMACH1BurstConfig(nsoc - 1, 1, 1);//one burst per ADCINT: every result in the block
+	DMACH1TransferConfig(len/nsoc - 1, -(nsoc - 1), 1);//after a burst, go back to the first result
+	DMACH1WrapConfig(0xFFFF, 0, 0xFFFF, 0);//wrap sizes larger than the transfer, so no wrapping
+	DMACH1ModeConfig((type == ADCINT1) ? DMA_SEQ1INT : DMA_SEQ2INT,//SEQ1INT is ADCINT1 on this chip
+		PERINT_ENABLE, ONESHOT_DISABLE, CONT_ENABLE, SYNC_DISABLE, SYNC_SRC,
+		OVRFLOW_DISABLE, SIXTEEN_BIT, CHINT_BEGIN, CHINT_ENABLE);//interrupt as a transfer begins
+	EALLOW;//TI's DMA routines each end with EDIS, but the caller likely still needs access
+}
+
+/**
+ * Start the DMA. Call after AdcStreamInit and after the DMACH1 interrupt has
+ * been registered with IsrInit.
+ */
+void AdcStreamStart() {
+	StartDMACH1();
+	EALLOW;//as above: StartDMACH1 ends with EDIS
 }
 
+/**
+ * Call this from the DMACH1 interrupt. The interrupt is thrown as each transfer
+ * begins, which is the moment the DMA has latched the address of the half it is
+ * about to fill. Here the other half (just completed) is queued up as the next
+ * destination and handed back to the caller, who has one half-buffer worth of
+ * conversions to process it before it gets overwritten.
+ *
+ * @return The half of the buffer that was just filled, or 0 on the very first
+ * 				transfer, when nothing has been filled yet
+ */
+Uint16* AdcStreamReady() {
+	Uint16* done;
+
+	xstreamnext ^= 1;//the DMA is now filling the half that used to be next
+	done = xstreambuf + xstreamnext*xstreamlen;
+
+	EALLOW;
+	DmaRegs.CH1.DST_BEG_ADDR_SHADOW = (Uint32)done;//so the finished half is refilled next
+	DmaRegs.CH1.DST_ADDR_SHADOW = (Uint32)done;
+	EDIS;
+
+	return (xstreamcnt++ == 0) ? 0 : done;
+}
@@ -1,86 +1,211 @@
-/**
- * @author Pavel Komarov <pvlkmrv@gmail.com> 941-545-7573
- * @version 1
- *
- * I went a little ham with the enums. Sorry not sorry.
- */
-
-//#include "interrupts.h"
-
-/**
- * Used to set the ADC module clock as a fraction
- * of the system clock.
- */
-typedef enum {
-    WHOLE,	HALF,	FOURTH
-} DIVISOR;
-
-/**
- * Specify which Start-Of-Conversion (soc) module you are
- * using. It's arbitrary and up to you, the user.
- */
-typedef enum {
-	SOC0 = 0,	SOC1 = 1,	SOC2 = 2,
-	SOC3 = 3,	SOC4 = 4,	SOC5 = 5,
-	SOC6 = 6,	SOC7 = 7,	SOC8 = 8,
-	SOC9 = 9,	SOC10 = 10,	SOC11 = 11,
-	SOC12 = 12,	SOC13 = 13,	SOC14 = 14,
-	SOC15 = 15
-} SOC;
-
-/**
- * Specify the channel (pin) to which an soc is
- * connected. Depends on the pin you use as input.
- */
-typedef enum {
-    ADCA0 = 0,	ADCA1 = 1,	ADCA2 = 2,
-    ADCA3 = 3,	ADCA4 = 4,	ADCA5 = 5,
-    ADCA6 = 6,	ADCA7 = 7,	ADCB0 = 8,
-    ADCB1 = 9,	ADCB2 = 10,	ADCB3 = 11,
-    ADCB4 = 12,	ADCB5 = 13,	ADCB6 = 14,
-    ADCB7 = 15
-} CHANNEL;
-
-/**
- * Specify the event that sets off a Start-Of-Convsion.
- * User choice.
- */
-typedef enum {
-	SOFTWARE = 0,	TINT0t = 1,		TINT1 = 2,//goofy t postpension is goofy,
-	TINT2 = 3,		XINT2t = 4,		PWM1A = 5,//but C does not allow
-	PWM1B = 6,		PWM2A = 7,		PWM2B = 8,//duplicate enum names, and
-	PWM3A = 9,		PWM3B = 10,		PWM4A = 11,//INTRPT already has a few of
-	PWM4B = 12,		PWM5A = 13,		PWM5B = 14,//of these. t is for "trigger"
-	PWM6A = 15,		PWM6B = 16,		PWM7A = 17,
-	PWM7B = 18,		PWM8A = 19,		PWM8B = 20
-} TRIGGER;
-
-/**
- * Avoid dependency on Interrupts Library. I have to repeat myself a little
- * here, but it averts a potentially frustrating-to-compile chained linkage
- * as well as the confusion of not having to include interrupts.h when
- * adc.h is included.
- */
-#ifndef INTRPT_DEFINED//This is the first time I have ever used #ifndef. It's cool.
-#define INTRPT_DEFINED
-typedef enum {
-    TINT0,		ADCINT1,	ADCINT2,
-    ADCINT3,	ADCINT4,	ADCINT5,
-    ADCINT6,	ADCINT7,	ADCINT8,
-    ADCINT9,	WAKEINT,	XINT1,
-    XINT2,		XINT3,		EPWM1,
-    EPWM2,		EPWM3,		EPWM4,
-    EPWM5,		EPWM6,		EPWM7,
-    EPWM8,		ECAN0,		ECAN1,
-    SCIARX,		SCIATX,		SCIBRX,
-    SCIBTX,		SPIARX,		SPIATX,
-    SPIBRX,		SPIBTX
-} INTRPT;
-#endif
-
-void AdcInit(void);
-void AdcSetClock(DIVISOR);
-void AdcSetupSOC(SOC, CHANNEL, TRIGGER);
-void AdcEnableIsr(SOC, INTRPT);
-void AdcStartMeas(SOC);
-float32 AdcRes(SOC);
+/**
+ * @author Pavel Komarov <pvlkmrv@gmail.com> 941-545-7573
+ * @version 1
+ *
+ * I went a little ham with the enums. Sorry not sorry.
+ */
+
+//#include "interrupts.h"
+
+/**
+ * Used to set the ADC module clock as a fraction
+ * of the system clock.
+ */
+typedef enum {
+    WHOLE,	HALF,	FOURTH
+} DIVISOR;
+
+/**
+ * Specify which Start-Of-Conversion (soc) module you are
+ * using. It's arbitrary and up to you, the user.
+ */
+typedef enum {
+	SOC0 = 0,	SOC1 = 1,	SOC2 = 2,
+	SOC3 = 3,	SOC4 = 4,	SOC5 = 5,
+	SOC6 = 6,	SOC7 = 7,	SOC8 = 8,
+	SOC9 = 9,	SOC10 = 10,	SOC11 = 11,
+	SOC12 = 12,	SOC13 = 13,	SOC14 = 14,
+	SOC15 = 15
+} SOC;
+
+/**
+ * Specify the channel (pin) to which an soc is
+ * connected. Depends on the pin you use as input.
+ */
+typedef enum {
+    ADCA0 = 0,	ADCA1 = 1,	ADCA2 = 2,
+    ADCA3 = 3,	ADCA4 = 4,	ADCA5 = 5,
+    ADCA6 = 6,	ADCA7 = 7,	ADCB0 = 8,
+    ADCB1 = 9,	ADCB2 = 10,	ADCB3 = 11,
+    ADCB4 = 12,	ADCB5 = 13,	ADCB6 = 14,
+    ADCB7 = 15
+} CHANNEL;
+
+/**
+ * Specify the event that sets off a Start-Of-Convsion.
+ * User choice.
+ */
+typedef enum {
+	SOFTWARE = 0,	TINT0t = 1,		TINT1 = 2,//goofy t postpension is goofy,
+	TINT2 = 3,		XINT2t = 4,		PWM1A = 5,//but C does not allow
+	PWM1B = 6,		PWM2A = 7,		PWM2B = 8,//duplicate enum names, and
+	PWM3A = 9,		PWM3B = 10,		PWM4A = 11,//INTRPT already has a few of
+	PWM4B = 12,		PWM5A = 13,		PWM5B = 14,//of these. t is for "trigger"
+	PWM6A = 15,		PWM6B = 16,		PWM7A = 17,
+	PWM7B = 18,		PWM8A = 19,		PWM8B = 20
+} TRIGGER;
+
+/**
+ * One row of a table of socs to be set up all at once with AdcSetupSOCs.
+ * acqps is the sample window minus one, in ADC clock cycles, 6 to 63.
+ */
+typedef struct {
+	SOC soc;
+	CHANNEL chan;
+	TRIGGER trig;
+	Uint16 acqps;
+} SOCSETUP;
+
+/**
+ * Index the soc control and result registers directly, for when even a
+ * function call is too much. For example ADCRESULT(SOC3) is AdcResult.ADCRESULT3.
+ */
+#define ADCSOCCTL(soc) ((&AdcRegs.ADCSOC0CTL)[soc])
+#define ADCRESULT(soc) ((&AdcResult.ADCRESULT0)[soc])
+
+/**
+ * Split the result of AdcPairRaw into its A and B halves.
+ */
+#define ADC_PAIR_A(p) ((Uint16)((p) & 0xFFFF))
+#define ADC_PAIR_B(p) ((Uint16)((p) >> 16))
+
+/**
+ * A board's calibration: the ADC core offset trim plus each channel's
+ * gain (Q24 per count) and offset (Q16), as used by AdcScaled.
+ */
+typedef struct {
+	Uint16 offtrim;
+	int32 gain[16];
+	int32 offset[16];
+} ADCCAL;
+
+/**
+ * A group of socs oversampling one channel. Filled in by AdcOversampleInit.
+ */
+typedef struct {
+	SOC first;
+	Uint16 n;//number of socs in the group
+	Uint16 shift;//right shift applied to the sum
+	Uint16 bits;//effective resolution of AdcOversampled's result
+} ADCOVERSAMPLE;
+
+/**
+ * State of a CIC (or, at order 1, boxcar) decimator. Filled in by AdcDecimatorInit.
+ */
+typedef struct {
+	Uint16 order;
+	Uint16 ratio;
+	Uint16 shift;
+	Uint16 count;
+	Uint32 integ[3];
+	Uint32 comb[3];
+	Uint16 out;//latest output, valid once AdcDecimate returns 1
+} ADCDECIMATOR;
+
+/**
+ * Turn a constant in engineering units into the Q16 that AdcScaled returns,
+ * so thresholds can be compared without floats. E.g. if (AdcScaled(SOC0) > ADC_Q16(30.0))
+ */
+#define ADC_Q16(x) ((int32)((x)*65536.0))
+
+/**
+ * Points in an ePWM period that can start a conversion. The values are the
+ * ePWM's own ETSEL codes. In up-down count mode, VALLEY is the middle of the
+ * low-side on-time and PEAK the middle of the high-side.
+ */
+typedef enum {
+	VALLEY = 1,		PEAK = 2,		VALLEYANDPEAK = 3,
+	CMPAUP = 4,		CMPADOWN = 5,	CMPBUP = 6,
+	CMPBDOWN = 7
+} PWMEVENT;
+
+/**
+ * A sample wanted from AdcSchedule: a channel, when in the PWM period to take
+ * it, and on every how many of those events (1 to 3). acqps is the sample window
+ * minus one, in ADC clocks (6 is the minimum). AdcSchedule fills in soc.
+ */
+typedef struct {
+	CHANNEL chan;
+	PWMEVENT event;
+	Uint16 every;
+	Uint16 acqps;
+	SOC soc;
+} ADCSAMPLE;
+
+/**
+ * Avoid dependency on Interrupts Library. I have to repeat myself a little
+ * here, but it averts a potentially frustrating-to-compile chained linkage
+ * as well as the confusion of not having to include interrupts.h when
+ * adc.h is included.
+ */
+#ifndef INTRPT_DEFINED//This is the first time I have ever used #ifndef. It's cool.
+#define INTRPT_DEFINED
+typedef enum {
+    TINT0,		ADCINT1,	ADCINT2,
+    ADCINT3,	ADCINT4,	ADCINT5,
+    ADCINT6,	ADCINT7,	ADCINT8,
+    ADCINT9,	WAKEINT,	XINT1,
+    XINT2,		XINT3,		EPWM1,
+    EPWM2,		EPWM3,		EPWM4,
+    EPWM5,		EPWM6,		EPWM7,
+    EPWM8,		ECAN0,		ECAN1,
+    SCIARX,		SCIATX,		SCIBRX,
+    SCIBTX,		SPIARX,		SPIATX,
+    SPIBRX,		SPIBTX,		DMACH1,
+    CLA1INT1,	CLA1INT2,	CLA1INT3,
+    CLA1INT4,	CLA1INT5,	CLA1INT6,
+    CLA1INT7,	CLA1INT8
+} INTRPT;
+#endif
+
+void AdcInit(void);
+void AdcSetClock(DIVISOR);
+void AdcSetFastestClock(float32);
+Uint16 AdcClockDivisor(void);
+Uint16 AdcMinAcqps(float32, float32);
+void AdcSetAcqps(SOC, Uint16);
+Uint32 AdcSocCycles(Uint16);
+float32 AdcMaxRate(float32, Uint16);
+void AdcSetupSOC(SOC, CHANNEL, TRIGGER);
+void AdcSetupSOCs(SOCSETUP*, Uint16);
+void AdcEnableIsr(SOC, INTRPT);
+void AdcStartMeas(SOC);
+float32 AdcRes(SOC);
+Uint16 AdcRaw(SOC);
+Uint16 AdcMillivolts(SOC);
+Uint16 AdcQ15(SOC);
+void AdcSetScale(CHANNEL, float32, float32);
+int32 AdcScaled(SOC);
+Uint16 AdcScaledAll(int32*);
+
+void AdcSetupPair(SOC, CHANNEL, TRIGGER);
+void AdcClearPair(SOC);
+Uint32 AdcPairRaw(SOC);
+void AdcPairScaled(SOC, int32*, int32*);
+
+void AdcCalibrateOffset(void);
+Uint16 AdcAverage(SOC, Uint16);
+void AdcCalibrate2Point(CHANNEL, Uint16, float32, Uint16, float32);
+void AdcGetCal(ADCCAL*);
+void AdcLoadCal(const ADCCAL*);
+
+void AdcOversampleInit(ADCOVERSAMPLE*, SOC, Uint16, CHANNEL, TRIGGER);
+Uint16 AdcOversampled(ADCOVERSAMPLE*);
+void AdcDecimatorInit(ADCDECIMATOR*, Uint16, Uint16);
+Uint16 AdcDecimate(ADCDECIMATOR*, Uint16);
+
+Uint16 AdcSchedule(Uint16, ADCSAMPLE*, Uint16);
+
+void AdcStreamInit(SOC, SOC, INTRPT, Uint16*, Uint16);
+void AdcStreamStart(void);
+Uint16* AdcStreamReady(void);
@@ -0,0 +1,478 @@
+/**
+ * @file adc_host.c
+ * @brief The indexed soc accessors against the switch versions they replaced
+ * @ingroup Digital
+ * @version 0
+ *
+ * http://solarracing.gatech.edu/wiki/Main_Page
+ * Not part of the target build. Builds adc.c on a PC, with the registers as
+ * plain memory and TI's routines stubbed out, next to AdcSetupSOC,
+ * AdcEnableIsr, AdcStartMeas and AdcRes as they were before they indexed into
+ * the registers (copied below with Switch on the end). It checks that each
+ * pair leaves the registers the same, then times them over every soc. It also
+ * checks a few of the other functions whose arithmetic has bitten before. From
+ * the top of the tree:
+ *
+ * gcc -O2 -w -D__cregister= -Dinterrupt= -D__interrupt= -Dcregister=
+ * 		-D'asm(x)=' -D'__asm(x)=' -I28069Common/h -I"System Libraries/ADC Library"
+ * 		"System Libraries/ADC Library/adc_host.c" -o adcbench
+ *
+ * Build it with -c instead and objdump -d the object to count each function's
+ * instructions. The times are the PC's. They say which way round the two are
+ * and by about how much, not what either costs on the F28069.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#define DSP28_DATA_TYPES//pin the C28x widths, so AdcPairRaw's 32-bit read stays 32 bits
+#define _TI_STD_TYPES
+typedef int16_t int16;
+typedef int32_t int32;
+typedef int64_t int64;
+typedef uint64_t Uint64;
+typedef float float32;
+typedef double float64;
+typedef uint32_t Uint32;
+typedef uint16_t Uint16;
+typedef uint8_t Uint8;
+#include "adc.c"
+
+volatile struct ADC_REGS AdcRegs;
+volatile struct ADC_RESULT_REGS AdcResult;
+volatile struct SYS_CTRL_REGS SysCtrlRegs;
+volatile struct DMA_REGS DmaRegs;
+volatile struct EPWM_REGS EPwm1Regs, EPwm2Regs, EPwm3Regs, EPwm4Regs,
+		EPwm5Regs, EPwm6Regs, EPwm7Regs, EPwm8Regs;
+
+//adc.c refers to these, but nothing here calls them
+void AdcOffsetSelfCal(void) {}
+void DSP28x_usDelay(Uint32 count) {}
+void DMAInitialize(void) {}
+void DMACH1AddrConfig(volatile Uint16* dst, volatile Uint16* src) {}
+void DMACH1BurstConfig(Uint16 size, int16 srcstep, int16 deststep) {}
+void DMACH1TransferConfig(Uint16 size, int16 srcstep, int16 deststep) {}
+void DMACH1WrapConfig(Uint16 srcsize, int16 srcstep, Uint16 dstsize, int16 dststep) {}
+void DMACH1ModeConfig(Uint16 persel, Uint16 perinte, Uint16 oneshot, Uint16 cont,
+		Uint16 synce, Uint16 syncsel, Uint16 ovrinte, Uint16 datasize, Uint16 chintmode,
+		Uint16 chinte) {}
+void StartDMACH1(void) {}
+
+#define LOOPS 2000000
+
+//The switch versions, as they were before they indexed into the registers
+static void AdcSetupSOCSwitch(SOC soc, CHANNEL chan, TRIGGER trig) {
+	switch (soc) {
+		case SOC0:
+			AdcRegs.ADCSOC0CTL.bit.CHSEL = chan;//Set socx to listen to ADCINyx
+			AdcRegs.ADCSOC0CTL.bit.TRIGSEL = trig;//Set soc to occur upon event
+			AdcRegs.ADCSOC0CTL.bit.ACQPS = 6;//"Sample window is 7 cycles long" (as brief as possible)
+			break;
+		case SOC1:
+			AdcRegs.ADCSOC1CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC1CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC1CTL.bit.ACQPS = 6;
+			break;
+		case SOC2:
+			AdcRegs.ADCSOC2CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC2CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC2CTL.bit.ACQPS = 6;
+			break;
+		case SOC3:
+			AdcRegs.ADCSOC3CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC3CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC3CTL.bit.ACQPS = 6;
+			break;
+		case SOC4:
+			AdcRegs.ADCSOC4CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC4CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC4CTL.bit.ACQPS = 6;
+			break;
+		case SOC5:
+			AdcRegs.ADCSOC5CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC5CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC5CTL.bit.ACQPS = 6;
+			break;
+		case SOC6:
+			AdcRegs.ADCSOC6CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC6CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC6CTL.bit.ACQPS = 6;
+			break;
+		case SOC7:
+			AdcRegs.ADCSOC7CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC7CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC7CTL.bit.ACQPS = 6;
+			break;
+		case SOC8:
+			AdcRegs.ADCSOC8CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC8CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC8CTL.bit.ACQPS = 6;
+			break;
+		case SOC9:
+			AdcRegs.ADCSOC9CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC9CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC9CTL.bit.ACQPS = 6;
+			break;
+		case SOC10:
+			AdcRegs.ADCSOC10CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC10CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC10CTL.bit.ACQPS = 6;
+			break;
+		case SOC11:
+			AdcRegs.ADCSOC11CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC11CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC11CTL.bit.ACQPS = 6;
+			break;
+		case SOC12:
+			AdcRegs.ADCSOC12CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC12CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC12CTL.bit.ACQPS = 6;
+			break;
+		case SOC13:
+			AdcRegs.ADCSOC13CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC13CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC13CTL.bit.ACQPS = 6;
+			break;
+		case SOC14:
+			AdcRegs.ADCSOC14CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC14CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC14CTL.bit.ACQPS = 6;
+			break;
+		case SOC15:
+			AdcRegs.ADCSOC15CTL.bit.CHSEL = chan;
+			AdcRegs.ADCSOC15CTL.bit.TRIGSEL = trig;
+			AdcRegs.ADCSOC15CTL.bit.ACQPS = 6;
+			break;
+	}
+}
+
+static void AdcEnableIsrSwitch(SOC soc, INTRPT type) {
+	switch (type) {
+		case ADCINT1:
+			AdcRegs.INTSEL1N2.bit.INT1SEL = soc;//set socx to throw to interrupt to ADCINTy
+			AdcRegs.INTSEL1N2.bit.INT1E = 1;//at its EOC (End Of Conversion)
+			break;
+		case ADCINT2:
+			AdcRegs.INTSEL1N2.bit.INT2SEL = soc;
+			AdcRegs.INTSEL1N2.bit.INT2E = 1;//Enable interrupt from ADCINTy
+			break;
+		case ADCINT3:
+			AdcRegs.INTSEL3N4.bit.INT3SEL = soc;
+			AdcRegs.INTSEL3N4.bit.INT3E = 1;
+			break;
+		case ADCINT4:
+			AdcRegs.INTSEL3N4.bit.INT4SEL = soc;
+			AdcRegs.INTSEL3N4.bit.INT4E = 1;
+			break;
+		case ADCINT5:
+			AdcRegs.INTSEL5N6.bit.INT5SEL = soc;
+			AdcRegs.INTSEL5N6.bit.INT5E = 1;
+			break;
+		case ADCINT6:
+			AdcRegs.INTSEL5N6.bit.INT6SEL = soc;
+			AdcRegs.INTSEL5N6.bit.INT6E = 1;
+			break;
+		case ADCINT7:
+			AdcRegs.INTSEL7N8.bit.INT7SEL = soc;
+			AdcRegs.INTSEL7N8.bit.INT7E = 1;
+			break;
+		case ADCINT8:
+			AdcRegs.INTSEL7N8.bit.INT8SEL = soc;
+			AdcRegs.INTSEL7N8.bit.INT8E = 1;
+			break;
+		case ADCINT9:
+			AdcRegs.INTSEL9N10.bit.INT9SEL = soc;
+			AdcRegs.INTSEL9N10.bit.INT9E = 1;
+			break;
+	}
+}
+
+static void AdcStartMeasSwitch(SOC soc) {
+	switch (soc) {
+		case SOC0:
+			AdcRegs.ADCSOCFRC1.bit.SOC0 = 1;
+			break;
+		case SOC1:
+			AdcRegs.ADCSOCFRC1.bit.SOC1 = 1;
+			break;
+		case SOC2:
+			AdcRegs.ADCSOCFRC1.bit.SOC2 = 1;
+			break;
+		case SOC3:
+			AdcRegs.ADCSOCFRC1.bit.SOC3 = 1;
+			break;
+		case SOC4:
+			AdcRegs.ADCSOCFRC1.bit.SOC4 = 1;
+			break;
+		case SOC5:
+			AdcRegs.ADCSOCFRC1.bit.SOC5 = 1;
+			break;
+		case SOC6:
+			AdcRegs.ADCSOCFRC1.bit.SOC6 = 1;
+			break;
+		case SOC7:
+			AdcRegs.ADCSOCFRC1.bit.SOC7 = 1;
+			break;
+		case SOC8:
+			AdcRegs.ADCSOCFRC1.bit.SOC8 = 1;
+			break;
+		case SOC9:
+			AdcRegs.ADCSOCFRC1.bit.SOC9 = 1;
+			break;
+		case SOC10:
+			AdcRegs.ADCSOCFRC1.bit.SOC10 = 1;
+			break;
+		case SOC11:
+			AdcRegs.ADCSOCFRC1.bit.SOC11 = 1;
+			break;
+		case SOC12:
+			AdcRegs.ADCSOCFRC1.bit.SOC12 = 1;
+			break;
+		case SOC13:
+			AdcRegs.ADCSOCFRC1.bit.SOC13 = 1;
+			break;
+		case SOC14:
+			AdcRegs.ADCSOCFRC1.bit.SOC14 = 1;
+			break;
+		case SOC15:
+			AdcRegs.ADCSOCFRC1.bit.SOC15 = 1;
+			break;
+	}
+}
+
+static float32 AdcResSwitch(SOC soc) {
+	switch (soc) {
+		case SOC0:
+			return 3.3*AdcResult.ADCRESULT0/4095;
+		case SOC1:
+			return 3.3*AdcResult.ADCRESULT1/4095;
+		case SOC2:
+			return 3.3*AdcResult.ADCRESULT2/4095;
+		case SOC3:
+			return 3.3*AdcResult.ADCRESULT3/4095;
+		case SOC4:
+			return 3.3*AdcResult.ADCRESULT4/4095;
+		case SOC5:
+			return 3.3*AdcResult.ADCRESULT5/4095;
+		case SOC6:
+			return 3.3*AdcResult.ADCRESULT6/4095;
+		case SOC7:
+			return 3.3*AdcResult.ADCRESULT7/4095;
+		case SOC8:
+			return 3.3*AdcResult.ADCRESULT8/4095;
+		case SOC9:
+			return 3.3*AdcResult.ADCRESULT9/4095;
+		case SOC10:
+			return 3.3*AdcResult.ADCRESULT10/4095;
+		case SOC11:
+			return 3.3*AdcResult.ADCRESULT11/4095;
+		case SOC12:
+			return 3.3*AdcResult.ADCRESULT12/4095;
+		case SOC13:
+			return 3.3*AdcResult.ADCRESULT13/4095;
+		case SOC14:
+			return 3.3*AdcResult.ADCRESULT14/4096;
+		case SOC15:
+			return 3.3*AdcResult.ADCRESULT15/4095;
+		default:
+			return 0;//to silence a warning
+	}
+}
+
+static int failures = 0;
+
+/**
+ * Run each old and new pair from the same register contents and compare what
+ * they leave behind.
+ */
+static void check(void) {
+	struct ADC_REGS switched;
+	Uint16 soc, chan, trig, type;
+	float32 a, b;
+
+	for (soc = 0; soc < 16; soc++) {
+		for (chan = 0; chan < 16; chan++) {
+			for (trig = 0; trig <= PWM8B; trig++) {
+				memset((void*)&AdcRegs, 0, sizeof(AdcRegs));
+				AdcSetupSOCSwitch(soc, chan, trig);
+				memcpy(&switched, (void*)&AdcRegs, sizeof(AdcRegs));
+				memset((void*)&AdcRegs, 0, sizeof(AdcRegs));
+				AdcSetupSOC(soc, chan, trig);
+				if (memcmp(&switched, (void*)&AdcRegs, sizeof(AdcRegs))) {
+					printf("FAIL AdcSetupSOC(%u, %u, %u)\n", soc, chan, trig);
+					failures++;
+				}
+			}
+		}
+		for (type = ADCINT1; type <= ADCINT9; type++) {
+			memset((void*)&AdcRegs, 0, sizeof(AdcRegs));
+			AdcRegs.INTSEL1N2.bit.INT1CONT = 1;//CONT bits must survive both
+			AdcRegs.INTSEL9N10.bit.INT10CONT = 1;
+			AdcEnableIsrSwitch(soc, type);
+			memcpy(&switched, (void*)&AdcRegs, sizeof(AdcRegs));
+			memset((void*)&AdcRegs, 0, sizeof(AdcRegs));
+			AdcRegs.INTSEL1N2.bit.INT1CONT = 1;
+			AdcRegs.INTSEL9N10.bit.INT10CONT = 1;
+			AdcEnableIsr(soc, type);
+			if (memcmp(&switched, (void*)&AdcRegs, sizeof(AdcRegs))) {
+				printf("FAIL AdcEnableIsr(%u, %u)\n", soc, type);
+				failures++;
+			}
+		}
+		memset((void*)&AdcRegs, 0, sizeof(AdcRegs));
+		AdcStartMeasSwitch(soc);
+		memcpy(&switched, (void*)&AdcRegs, sizeof(AdcRegs));
+		memset((void*)&AdcRegs, 0, sizeof(AdcRegs));
+		AdcStartMeas(soc);
+		if (memcmp(&switched, (void*)&AdcRegs, sizeof(AdcRegs))) {
+			printf("FAIL AdcStartMeas(%u)\n", soc);
+			failures++;
+		}
+		(&AdcResult.ADCRESULT0)[soc] = 4095 - 37*soc;
+		a = AdcResSwitch(soc);
+		b = AdcRes(soc);
+		if (a != b && soc != SOC14) {//SOC14 used to divide by 4096
+			printf("FAIL AdcRes(%u): %f and %f\n", soc, a, b);
+			failures++;
+		}
+	}
+}
+
+/**
+ * ACQPS is 6 bits: out-of-range windows must clamp, not wrap.
+ */
+static void checkAcqps(void) {
+	static const Uint16 in[5] = {0, 6, 63, 64, 70}, want[5] = {6, 6, 63, 63, 63};
+	SOCSETUP setup = {SOC3, ADCB2, PWM2A, 0};
+	Uint16 i;
+
+	for (i = 0; i < 5; i++) {
+		memset((void*)&AdcRegs, 0, sizeof(AdcRegs));
+		AdcSetAcqps(SOC3, in[i]);
+		if (AdcRegs.ADCSOC3CTL.bit.ACQPS != want[i]) {
+			printf("FAIL AdcSetAcqps(%u) gave %u\n", in[i], AdcRegs.ADCSOC3CTL.bit.ACQPS);
+			failures++;
+		}
+		setup.acqps = in[i];
+		AdcSetupSOCs(&setup, 1);
+		if (AdcRegs.ADCSOC3CTL.bit.ACQPS != want[i] || AdcRegs.ADCSOC3CTL.bit.CHSEL != ADCB2
+				|| AdcRegs.ADCSOC3CTL.bit.TRIGSEL != PWM2A) {
+			printf("FAIL AdcSetupSOCs with acqps %u\n", in[i]);
+			failures++;
+		}
+	}
+}
+
+/**
+ * The odd soc of a simultaneous pair holds the B channel and must be scaled
+ * with its table, the same by every route.
+ */
+static void checkPairScale(void) {
+	int32 all[16], a, b;
+	Uint16 n;
+
+	memset((void*)&AdcRegs, 0, sizeof(AdcRegs));
+	xactive = 0;
+	AdcSetScale(ADCA2, 1.0, 0.0);
+	AdcSetScale(ADCB2, 10.0, -5.0);
+	AdcSetupPair(SOC4, ADCA2, PWM1A);
+	AdcResult.ADCRESULT4 = 1000;
+	AdcResult.ADCRESULT5 = 3000;
+	AdcPairScaled(SOC4, &a, &b);
+	n = AdcScaledAll(all);
+	if (n != 2 || all[0] != a || all[1] != b || AdcScaled(SOC5) != b) {
+		printf("FAIL AdcScaled on a pair: %ld %ld, AdcPairScaled says %ld %ld\n",
+				(long)all[0], (long)all[1], (long)a, (long)b);
+		failures++;
+	}
+	AdcClearPair(SOC4);//sequential again: SOC5 converted its CHSEL, ADCA2
+	if (AdcScaled(SOC5) != (int32)(((int64)3000*xgain[ADCA2]) >> 8) + xoff[ADCA2]) {
+		printf("FAIL AdcScaled after AdcClearPair\n");
+		failures++;
+	}
+}
+
+/**
+ * Two groups triggered at the same point in the period run as one burst, so
+ * they fit whenever their total does.
+ */
+static void checkSchedule(void) {
+	ADCSAMPLE samples[2] = {{ADCA0, VALLEY, 1, 6}, {ADCA3, VALLEY, 3, 6}};
+	Uint16 fits;
+
+	memset((void*)&AdcRegs, 0, sizeof(AdcRegs));//ADC clock = SYSCLK: 20 cycles a soc
+	memset((void*)&EPwm1Regs, 0, sizeof(EPwm1Regs));
+	EPwm1Regs.TBCTL.bit.CTRMODE = 2;//up-down
+	EPwm1Regs.TBPRD = 1000;
+	xactive = 0;
+	fits = AdcSchedule(1, samples, 2);
+	if (!fits || samples[0].soc != SOC0 || samples[1].soc != SOC1) {
+		printf("FAIL AdcSchedule: coincident groups rejected\n");
+		failures++;
+	}
+	EPwm1Regs.TBPRD = 15;//a 30 cycle period can't hold 40 cycles of conversions
+	xactive = 0;
+	if (AdcSchedule(1, samples, 2)) {
+		printf("FAIL AdcSchedule: took coincident groups longer than the period\n");
+		failures++;
+	}
+}
+
+/**
+ * @return ns per call, cycling through the socs so the switch can't settle
+ */
+static double timeSetup(void (*fn)(SOC, CHANNEL, TRIGGER)) {
+	clock_t start = clock();
+	Uint32 i;
+
+	for (i = 0; i < LOOPS; i++) {
+		fn((SOC)(i & 15), (CHANNEL)((i >> 4) & 15), PWM1A);
+	}
+	return (double)(clock() - start)/CLOCKS_PER_SEC*1e9/LOOPS;
+}
+
+static double timeIsr(void (*fn)(SOC, INTRPT)) {
+	clock_t start = clock();
+	Uint32 i;
+
+	for (i = 0; i < LOOPS; i++) {
+		fn((SOC)(i & 15), (INTRPT)(ADCINT1 + i % 9));
+	}
+	return (double)(clock() - start)/CLOCKS_PER_SEC*1e9/LOOPS;
+}
+
+static double timeStart(void (*fn)(SOC)) {
+	clock_t start = clock();
+	Uint32 i;
+
+	for (i = 0; i < LOOPS; i++) {
+		fn((SOC)(i & 15));
+	}
+	return (double)(clock() - start)/CLOCKS_PER_SEC*1e9/LOOPS;
+}
+
+static double timeRes(float32 (*fn)(SOC)) {
+	volatile float32 sink = 0;
+	clock_t start = clock();
+	Uint32 i;
+
+	for (i = 0; i < LOOPS; i++) {
+		sink += fn((SOC)(i & 15));
+	}
+	return (double)(clock() - start)/CLOCKS_PER_SEC*1e9/LOOPS;
+}
+
+int main(void) {
+	check();
+	checkAcqps();
+	checkPairScale();
+	checkSchedule();
+	printf("ns per call      switch  indexed\n");
+	printf("AdcSetupSOC     %7.2f  %7.2f\n", timeSetup(&AdcSetupSOCSwitch), timeSetup(&AdcSetupSOC));
+	printf("AdcEnableIsr    %7.2f  %7.2f\n", timeIsr(&AdcEnableIsrSwitch), timeIsr(&AdcEnableIsr));
+	printf("AdcStartMeas    %7.2f  %7.2f\n", timeStart(&AdcStartMeasSwitch), timeStart(&AdcStartMeas));
+	printf("AdcRes          %7.2f  %7.2f\n", timeRes(&AdcResSwitch), timeRes(&AdcRes));
+	printf(failures ? "%d FAILED\n" : "ok\n", failures);
+	return failures != 0;
+}
@@ -1,504 +1,1032 @@
-/*//###########################################################################
- *
- * @file main.c
- * @author Ricky Liou <rliou92@gmail.com> 404-451-7986
- * @brief This file contains the CAN API for the microcontrollers to communicate with each other.
- * @warning Has not been thoroughly tested, might have bugs.
- * @ingroup CAN
- *
- * Description:
- *
- * CAN receiver and sender functions
- *
- * Improvements:
- * Can use acceptance masks
- * Support for more interrupt types
- * System level interrupts
- * Error checking
- * Timer functions
- *
- * Concerns:
- * 	In self test mode, I can successfully send and receive messages with no connection to bus!
- *
-//###########################################################################*/
-
-
-#include "DSP28x_Project.h"
-#include "CAN.h"
-#include <stdio.h>
-#include <stdlib.h>
-//Global variables
-int DEBUG = 1;
-int bus_error = 0;
-CAN_INFO* CAN_INFO_ARRAY;
-Uint32 CAN_ARRAY_LENGTH;
-
-#define CAN_TX_WAIT_CYCLES 150e3
-__interrupt void ecan_isr(void);
-
-
-/*
-USER DEFINED CAN_INFO ARRAY EXAMPLE
-
-void imu_send_isr(CAN_ID ID, Uint32 dataH, Uint32 dataL, Uint16 length, int mbox_num){
-	char string[] = "Sent";
-	//puts(string);
-}
-
-void imu_receive_isr(CAN_ID ID, Uint32 dataH, Uint32 dataL, Uint16 length, int mbox_num){
-	char string[32];
-	//sprintf(string, "Received %d %d", dataH, dataL);
-	//puts(string);
-}
-
-CAN_INFO SENSOR_CAN_INFO_ARRAY[] = {
-	{
-		IMU,
-		&imu_send_isr,
-		&imu_receive_isr
-	}
-};
-
-TESTING PROJECT MAIN FUNCTION EXAMPLE
-
-void main(void){
-
-	Uint32 test_data[] = {1,2,3};
-
-	CAN_init(SENSOR_CAN_INFO_ARRAY, 1, 1); // Initialize CAN with interrupts.
-
-	CAN_receive(PEDALS, 12, 4, 0);
-	CAN_send(test_data, 12, PEDALS, 7, 0);
-
-	CAN_autoreply(test_data, 2, PEDALS, 4, 0);
-	CAN_request(PEDALS, 7, 0, 0);
-
-
-	while(1);
-}*/
-
-
-
-char interruptsEnabled;
-/*
-@brief Initializes the CAN module
- */
-
-void CAN_init(CAN_INFO* can_array, Uint32 can_length, char enableInterrupts){
-	interruptsEnabled = enableInterrupts;
-	struct ECAN_REGS ECanaShadow;
-	Uint16 IERShadow;
-	CAN_INFO_ARRAY = can_array;
-	CAN_ARRAY_LENGTH = can_length;
-
-	// Step 1. Initialize System Control:
-	// PLL, WatchDog, enable Peripheral Clocks
-	// This function is found in the F2806x_SysCtrl.c file.
-	// Should be commented out in regular usage. For normal usage initializing the system should be done elsewhere not in the CAN code.
-	// For testing purposes this is uncommented to initialize the system.
-	//   InitSysCtrl();
-
-	// Step 2. Initialize GPIO:
-	// Configure CAN pins using GPIO regs here
-	// This function is found in F2806x_ECan.c
-	InitECanGpio();
-
-	if (enableInterrupts) {
-		// FOR MOTOR CONTROLLER: NO INTERRUPTS!
-		// Step 3. Clear all interrupts and initialize PIE vector table:
-		// Disable CPU interrupts
-		DINT;
-
-		// Disable CPU interrupts and clear all CPU interrupt flags
-		// Save interrupts that were previously enabled
-		IERShadow = IER;
-		IER = 0x0000;
-		IFR = 0x0000;
-
-		EALLOW;
-		//Direct ECANA1 interrupts to the proper isr
-		PieVectTable.ECAN1INTA = &ecan_isr;
-		//Direct ECANA0 interupts to proper isr
-		PieVectTable.ECAN0INTA = &ecan_isr;
-		EDIS;
-
-		// Enable the PIE Vector Table
-		PieCtrlRegs.PIECTRL.bit.ENPIE = 1;
-	}
-	EALLOW;
-	SysCtrlRegs.PCLKCR0.bit.ECANAENCLK = 1;      // eCAN-A
-	EDIS;
-
-	// Step 4. Initialize CAN module
-	InitECana();
-
-
-
-	if (enableInterrupts) {
-		EALLOW;
-		//Allow all mailboxes to send interrupts
-		ECanaRegs.CANMIM.all = 0xFFFFFFFF;
-		//Using level 1 CAN interrupts  for mboxes
-		ECanaRegs.CANMIL.all = 0xFFFFFFFF;
-		//From all system interrupts only use bus-off (not recommended)
-		//Enable level 0, 1 interrupts
-		ECanaRegs.CANGIM.all = 0x00000403;
-
-		//CAN interrupts are part of IER 9
-		IER = IERShadow | M_INT9;
-
-		//Enable ECAN interrupt 0 in PIE
-		PieCtrlRegs.PIEIER9.bit.INTx5 = 1;
-		//Enable ECAN interrupt 1 in PIE
-		PieCtrlRegs.PIEIER9.bit.INTx6 = 1;
-	}
-
-	ECanaShadow.CANMC.all = ECanaRegs.CANMC.all;
-	ECanaShadow.CANMC.bit.STM = 0;    // Disable CAN self-test mode (0=off)
-	ECanaRegs.CANMC.all = ECanaShadow.CANMC.all;
-
-	if (enableInterrupts) {
-		// Enable global Interrupts and higher priority real-time debug events:
-		EINT;   // Enable Global interrupt INTM
-		ERTM;   // Enable Global realtime interrupt DBGM
-	}
-	EDIS;
-}
-
-//@brief Data must be array of {Lower 4 bytes, Higher 4 bytes, etc}
-//Sends data starting from specified mailbox. If mailbox exceeds 31, then it will wrap around starting from 0.
-//Length is in units of bytes.
-//Data must be given multiple of 8 bytes, even if you're not sending 8 bytes!
-//Data is sent starting from lower 4 bytes.
-//	Ex: PEDALS sends out 4 bytes of data from mailbox 4 + 5
-//	CAN_SEND(data_array_pointer, 4, PEDALS, 4);
-void CAN_send(Uint32* data, int length, CAN_ID ID, Uint32 mbox_num, char block){
-	struct ECAN_REGS ECanaShadow;
-	volatile struct MBOX *Mailbox;
-	Uint32 wait_cycles;
-
-	// How many mailboxes need to be used?
-	Uint32 numMbox;
-	if(length%8){
-		numMbox = length/8 + 1;
-	}
-	else{
-		numMbox = length/8;
-	}
-
-	// Sets 1s to the mailboxes affected, 0s otherwise.
-	Uint32 bitMaskOfOnes = (((Uint32)1 << (numMbox)) - (Uint32)1) << (mbox_num);
-
-	// ECanaRegs.CANTRR.all |= bitMaskOfOnes; //Clear TRS bits
-	ECanaShadow.CANTRR.all = ECanaRegs.CANTRR.all;
-	ECanaShadow.CANTRR.all |= bitMaskOfOnes;
-	ECanaRegs.CANTRR.all = ECanaShadow.CANTRR.all;
-
-	// Wait until transmit request set bits are cleared
-	wait_cycles = 0;
-	while ((ECanaRegs.CANTRS.all & bitMaskOfOnes) && wait_cycles < CAN_TX_WAIT_CYCLES) wait_cycles++; // TRY to wait for CANTRS to be ready, but do not wait forever.
-
-	// ECanaRegs.CANME.all &= ~bitMaskOfOnes; //Disable the mailboxes to modify their content
-	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
-	ECanaShadow.CANME.all &= ~bitMaskOfOnes;
-	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
-
-	// ECanaRegs.CANMD.all &= ~bitMaskOfOnes; //Configure mailboxes for transmit
-	ECanaShadow.CANMD.all = ECanaRegs.CANMD.all;
-	ECanaShadow.CANMD.all &= ~bitMaskOfOnes;// 0 for transmit
-	ECanaRegs.CANMD.all = ECanaShadow.CANMD.all;
-
-	Uint32 i;
-	for (i=0; i< numMbox; i++){
-		// Construct pointer to the correct mailbox register.
-		// Starts off from mailbox 0 and increments from there.
-		Mailbox = &ECanaMboxes.MBOX0 + ((i + mbox_num) % 32);
-
-		if(length >= 8){
-			//Data-length code. The number in these bits determines how many data bytes are sent or received. Valid value range is from 0 to 8. Values from 9 to 15 are not allowed.
-			Mailbox->MSGCTRL.bit.DLC = 8;
-			length -= 8;
-		}
-		else{
-			Mailbox->MSGCTRL.bit.DLC = length;
-		}
-
-		Mailbox->MDL.all = data[2*i];
-
-		// Make sure that the next data array value exists
-		if(length >= 0) {
-			Mailbox->MDH.all = data[2*i+1];
-		}
-		else {
-			Mailbox->MDH.all = 0;
-		}
-
-		// The ID is only the last 29 bits. ID cannot be greater than 2^29-1.
-		// I am using the extended identifier only.
-		Mailbox->MSGID.bit.STDMSGID = (Uint32)ID;
-		Mailbox->MSGID.bit.AAM = 0;
-		Mailbox->MSGID.bit.AME = 0;
-		Mailbox->MSGID.bit.IDE = 0;
-	}
-	//ECanaRegs.CANME.all |= bitMaskOfOnes; //Enable the mailboxes
-	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
-	ECanaShadow.CANME.all |= bitMaskOfOnes;
-	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
-
-	//ECanaRegs.CANTRS.all |= bitMaskOfOnes; //Send the data all at once!
-	ECanaShadow.CANTRS.all = ECanaRegs.CANTRS.all;
-	ECanaShadow.CANTRS.all |= bitMaskOfOnes;
-	ECanaRegs.CANTRS.all = ECanaShadow.CANTRS.all;
-
-	if(block) {
-		while(ECanaRegs.CANTA.all != ~bitMaskOfOnes ) {}  // Wait for all TAn bits to be set..
-	}
-}
-
-/*
- * @brief Configure mailboxes to receive *length* bytes from desired CAN ID
- * If mailbox number exceeds 31, then it will wrap around starting at 0.
- */
-void CAN_receive(CAN_ID ID, int length, Uint32 mbox_num, char block){
-	struct ECAN_REGS ECanaShadow;
-	volatile struct MBOX *Mailbox;
-
-	//How many mailboxes need to be used?
-	Uint32 numMbox;
-	if(length%8){
-		numMbox = length/8 + 1;
-	}
-	else{
-		numMbox = length/8;
-	}
-
-	Uint32 bitMaskOfOnes = (((Uint32)1 << (numMbox)) - (Uint32)1) << (mbox_num);
-
-	//ECanaRegs.CANME.all &= ~mbox_mask; //Disable the mailboxes to modify their content
-	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
-	ECanaShadow.CANME.all &= ~bitMaskOfOnes;
-	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
-
-	//ECanaRegs.CANMD.all |= mbox_mask; //Configure mailbox for receive
-	ECanaShadow.CANMD.all = ECanaRegs.CANMD.all;
-	ECanaShadow.CANMD.all |= bitMaskOfOnes;
-	ECanaRegs.CANMD.all = ECanaShadow.CANMD.all;
-
-	Uint32 i;
-	for (i=0; i< numMbox; i++){
-		// Construct pointer to the correct mailbox register.
-		// Starts off from mailbox 0 and increments from there.
-		Mailbox = &ECanaMboxes.MBOX0 + ((i + mbox_num) % 32);
-
-		if(length >= 8){
-			Mailbox->MSGCTRL.bit.DLC = 8;
-			length -= 8;
-		}
-		else{
-			Mailbox->MSGCTRL.bit.DLC = length;
-		}
-
-		// The ID is only the last 29 bits. ID cannot be greater than 2^29-1.
-		// I am using the extended identifier only.
-		Mailbox->MSGID.all = (Uint32)ID<<18;
-		Mailbox->MSGID.bit.AAM = 0;
-		Mailbox->MSGID.bit.AME = 0;
-		Mailbox->MSGID.bit.IDE = 0;
-	}
-
-	//ECanaRegs.CANME.all |= mbox_mask; //Enable the mailboxes
-	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
-	ECanaShadow.CANME.all |= bitMaskOfOnes;
-	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
-
-	if(block){
-		while(ECanaRegs.CANRMP.all ^ bitMaskOfOnes ){}
-	}
-}
-/*
- * @brief Request data from specified mailbox
- * length is in bytes
- */
-void CAN_request(CAN_ID ID, int length, Uint32 mbox_num, char block){
-	struct ECAN_REGS ECanaShadow;
-	volatile struct MBOX *Mailbox;
-
-	// How many mailboxes need to be used?
-	Uint32 numMbox;
-	if(length%8){
-		numMbox = length/8 + 1;
-	}
-	else{
-		numMbox = length/8;
-	}
-
-	Uint32 bitMaskOfOnes = (((Uint32)1 << (numMbox)) - (Uint32)1) << (mbox_num);
-
-	//ECanaRegs.CANME.all &= ~mbox_mask; //Disable the mailboxes to modify their content
-	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
-	ECanaShadow.CANME.all &= ~bitMaskOfOnes;
-	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
-
-	//ECanaRegs.CANMD.all |= mbox_mask; //Configure mailbox for receive
-	ECanaShadow.CANMD.all = ECanaRegs.CANMD.all;
-	ECanaShadow.CANMD.all |= bitMaskOfOnes;
-	ECanaRegs.CANMD.all = ECanaShadow.CANMD.all;
-
-	Uint32 i;
-	for (i=0; i< numMbox; i++){
-		// Construct pointer to the correct mailbox register.
-		// Starts off from mailbox 0 and increments from there.
-		Mailbox = &ECanaMboxes.MBOX0 + ((i + mbox_num) % 32);
-
-		if(length >= 8){
-			Mailbox->MSGCTRL.bit.DLC = 8;
-			length -= 8;
-		}
-		else{
-			Mailbox->MSGCTRL.bit.DLC = length;
-		}
-		Mailbox->MSGCTRL.bit.RTR = 1;// Set request flag
-
-		// The ID is only the last 29 bits. ID cannot be greater than 2^29-1.
-		// I am using the extended identifier only.
-		Mailbox->MSGID.all = (Uint32)ID<<18;
-		Mailbox->MSGID.bit.AAM = 0;
-		Mailbox->MSGID.bit.AME = 0;
-		Mailbox->MSGID.bit.IDE = 0;
-	}
-
-	//ECanaRegs.CANME.all |= mbox_mask; // Enable the mailboxes
-	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
-	ECanaShadow.CANME.all |= bitMaskOfOnes;
-	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
-
-	//ECanaRegs.CANTRS.all |= mbox_mask;// Request!
-	ECanaShadow.CANTRS.all = ECanaRegs.CANTRS.all;
-	ECanaShadow.CANTRS.all |= bitMaskOfOnes;
-	ECanaRegs.CANTRS.all = ECanaShadow.CANTRS.all;
-
-	if(block){
-		while(ECanaRegs.CANTA.all != ~bitMaskOfOnes ) {}  // Wait for all TAn bits to be set..
-	}
-}
-
-// @brief Set up a mailbox to automatically send data upon request. Length in bytes.
-
-void CAN_autoreply(Uint32* data, int length, CAN_ID ID, Uint32 mbox_num, char block){
-	struct ECAN_REGS ECanaShadow;
-	volatile struct MBOX *Mailbox;
-
-	// How many mailboxes need to be used?
-	Uint32 numMbox;
-	if(length%8) {
-		numMbox = length/8 + 1;
-	} else {
-		numMbox = length/8;
-	}
-
-	Uint32 bitMaskOfOnes = (((Uint32)1 << (numMbox)) - (Uint32)1) << (mbox_num);
-
-	//ECanaRegs.CANTRR.all |= bitMaskOfOnes; //Clear TRS bits
-	ECanaShadow.CANTRR.all = ECanaRegs.CANTRR.all;
-	ECanaShadow.CANTRR.all |= bitMaskOfOnes;
-	ECanaRegs.CANTRR.all = ECanaShadow.CANTRR.all;
-
-	while(ECanaRegs.CANTRS.all & bitMaskOfOnes); //Wait until TRS bits are cleared
-
-	//ECanaRegs.CANME.all &= ~bitMaskOfOnes; //Disable the mailboxes to modify their content
-	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
-	ECanaShadow.CANME.all &= ~bitMaskOfOnes;
-	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
-
-	//ECanaRegs.CANMD.all &= ~bitMaskOfOnes; //Configure mailboxes for transmit
-	ECanaShadow.CANMD.all = ECanaRegs.CANMD.all;
-	ECanaShadow.CANMD.all &= ~bitMaskOfOnes;
-	ECanaRegs.CANMD.all = ECanaShadow.CANMD.all;
-
-	int i;
-	for (i=0; i< numMbox; i++){
-		Mailbox = &ECanaMboxes.MBOX0 + i + mbox_num;
-
-		if(length >= 8){
-			Mailbox->MSGCTRL.bit.DLC = 8;
-			length -= 8;
-		}
-		else{
-			Mailbox->MSGCTRL.bit.DLC = length;
-		}
-		Mailbox->MDL.all = data[2*i];
-
-		// Make sure that the next data array value exists
-		if(length >= 0) {
-			Mailbox->MDH.all = data[2*i+1];
-		}
-		else {
-			Mailbox->MDH.all = 0;
-		}
-
-		// The ID is only the last 29 bits. ID cannot be greater than 2^29-1.
-		// I am using the extended identifier only.
-		Mailbox->MSGID.all = (Uint32) ID;
-		Mailbox->MSGID.bit.AAM = 1; // Auto answer mode is on
-		Mailbox->MSGID.bit.AME = 0;
-		Mailbox->MSGID.bit.IDE = 1;
-	}
-	//ECanaRegs.CANME.all |= bitMaskOfOnes; //Enable the mailboxes
-	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
-	ECanaShadow.CANME.all |= bitMaskOfOnes;
-	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
-
-	if(block){
-		while(ECanaRegs.CANTA.all != ~bitMaskOfOnes ) {}  // Wait for all TAn bits to be set..
-	}
-}
-
-//@brief Based on the the event which triggered the interrupt (sent or received), calls the user specified function
-
-//checks what threw the interrupt (after a send or receive)
-__interrupt void ecan_isr(void){
-	puts("ecan_isr called");
-	//Extract mailbox number, CAN ID, data, execute desired user function
-	struct ECAN_REGS ECanaShadow;
-
-	ECanaShadow.CANGIF0.all = ECanaRegs.CANGIF0.all;
-	if(ECanaShadow.CANGIF0.bit.BOIF0){
-		bus_error = 1;
-		if(DEBUG)
-			puts("CAN BUS ERROR");
-		ECanaShadow.CANGIF0.bit.BOIF0 |= 1; // Clear bus off interrupt flag by writing a 1. Doesn't seem to actually reset.
-		EALLOW;
-		ECanaRegs.CANGIF0.all = ECanaShadow.CANGIF0.all;
-		ECanaRegs.CANMC.bit.CCR = 0;
-		EDIS;
-	}
-	else{
-		Uint32 i;
-		Uint32 ID;
-		volatile struct MBOX *Mailbox;
-
-		//Determine which mailbox generated the interrupt
-		Uint16 mbox_num = ECanaRegs.CANGIF1.bit.MIV1;
-		Mailbox = &ECanaMboxes.MBOX0 + mbox_num;
-		Uint32 mbox_mask = (Uint32) 1 << (Uint32) mbox_num;
-
-		ID = Mailbox->MSGID.bit.STDMSGID; //The ID is only the last 29 bits.
-		for(i=0; i< CAN_ARRAY_LENGTH; i++){
-			if(CAN_INFO_ARRAY[i].ID == (Uint32)ID){
-				if(ECanaRegs.CANTA.all & mbox_mask){ //If TA bit is set
-					CAN_INFO_ARRAY[i].upon_sent_isr(CAN_INFO_ARRAY[i].ID,Mailbox->MDH.all, Mailbox->MDL.all,Mailbox->MSGCTRL.bit.DLC,mbox_num);
-					ECanaRegs.CANTA.all |= mbox_mask; //Clear TA bit by writing 1
-					if(DEBUG) {
-						puts("CAN sent ISR");
-					}
-				}
-				else if(ECanaRegs.CANRMP.all & mbox_mask){ //If RMP bit is set
-					CAN_INFO_ARRAY[i].upon_receive_isr(CAN_INFO_ARRAY[i].ID, Mailbox->MDH.all, Mailbox->MDL.all,Mailbox->MSGCTRL.bit.DLC, mbox_num);
-					ECanaRegs.CANRMP.all |= mbox_mask; //Clear RMP bit by writing 1
-				}
-			}
-		}
-	}
-	PieCtrlRegs.PIEACK.bit.ACK9 = 1; //Acknowledge interrupt
-}
-
+/*//###########################################################################
+ *
+ * @file main.c
+ * @author Ricky Liou <rliou92@gmail.com> 404-451-7986
+ * @brief This file contains the CAN API for the microcontrollers to communicate with each other.
+ * @warning Has not been thoroughly tested, might have bugs.
+ * @ingroup CAN
+ *
+ * Description:
+ *
+ * CAN receiver and sender functions
+ *
+ * Improvements:
+ * Can use acceptance masks
+ * Support for more interrupt types
+ * System level interrupts
+ * Error checking
+ * Timer functions
+ *
+ * Concerns:
+ * 	In self test mode, I can successfully send and receive messages with no connection to bus!
+ *
+//###########################################################################*/
+
+
+#include "DSP28x_Project.h"
+#include "CAN.h"
+//Global variables
+CAN_INFO* CAN_INFO_ARRAY;
+Uint32 CAN_ARRAY_LENGTH;
+
+// Receive dispatch. The ISR must not search CAN_INFO_ARRAY, so:
+// CAN_MBOX_TABLE maps each mailbox to the CAN_INFO it was configured for (filled in whenever
+// CAN_send/receive/request/autoreply sets a mailbox up), and CAN_ID_INDEX is CAN_INFO_ARRAY
+// sorted by ID, so that the rare frame landing in a mailbox it wasn't configured for can still
+// be found by binary search.
+CAN_INFO* CAN_MBOX_TABLE[CAN_MBOXES];
+CAN_INFO* CAN_ID_INDEX[CAN_MAX_INFO];
+Uint32 CAN_INDEX_LENGTH;
+
+// Transmit queue. CAN_send never touches a mailbox that is still busy; it puts frames in
+// CAN_TX_HEAP, a binary heap ordered by ID (lowest first, as on the bus) and then by the order
+// they were queued in. Mailboxes in CAN_TX_POOL are handed out to the head of the heap whenever
+// one is free, and the TA interrupt of each hands it the next frame.
+typedef struct{
+	CAN_FRAME frame;
+	Uint32 seq;
+}CAN_TX_ENTRY;
+
+CAN_TX_ENTRY CAN_TX_HEAP[CAN_TX_QUEUE_SIZE];
+Uint16 CAN_TX_COUNT;
+Uint32 CAN_TX_SEQ;
+Uint32 CAN_TX_POOL;					// Mailboxes reserved for the queue
+volatile Uint32 CAN_TX_BUSY;		// Of those, the ones loaded and waiting for TA
+CAN_ID CAN_TX_INFLIGHT[CAN_MBOXES];	// ID loaded into each busy mailbox
+Uint32 CAN_TX_INFLIGHT_SEQ[CAN_MBOXES];	// and its place in the order frames were queued
+Uint32 CAN_TX_DROPPED;				// Frames refused because the queue was full
+void (*CAN_tx_hook)(CAN_ID ID);		// If set, told each time a queued frame has gone out
+void (*CAN_rx_hook)(Uint16 mbox_num);	// If set, shown every received frame before it is dispatched
+
+// Bus errors. The controller's own fault confinement takes it from error-active to warning to
+// passive to bus-off; ecan_isr (or CAN_error_poll, without interrupts) follows it there and holds it
+// off the bus with CCR. CAN_error_poll lets it back on once CAN_STATUS.backoff ms have passed.
+CAN_BUS_STATUS CAN_STATUS;
+const CAN_BUS_STATUS CAN_STATUS_CLEAR = {CAN_ERROR_ACTIVE};
+Uint16 CAN_OFF_TIMED;				// CAN_STATUS.off_since has been set for this bus-off
+#define CAN_ES_ERRORS 0x01F80000	// ACKE, SE, CRCE, SA1, BE, FE: sticky, cleared by writing 1
+
+// Critical sections that put INTM back the way they found it, unlike DINT/EINT
+#define CAN_LOCK() Uint16 can_intm = __disable_interrupts()
+#define CAN_UNLOCK() __restore_interrupts(can_intm)
+
+__interrupt void ecan_isr(void);
+static void CAN_bind(Uint32 mbox_mask, CAN_ID ID);
+static void CAN_tx_fill(void);
+static void CAN_error_check(void);
+
+
+/*
+USER DEFINED CAN_INFO ARRAY EXAMPLE
+
+void imu_send_isr(CAN_ID ID, Uint32 dataH, Uint32 dataL, Uint16 length, int mbox_num){
+	char string[] = "Sent";
+	//puts(string);
+}
+
+void imu_receive_isr(CAN_ID ID, Uint32 dataH, Uint32 dataL, Uint16 length, int mbox_num){
+	char string[32];
+	//sprintf(string, "Received %d %d", dataH, dataL);
+	//puts(string);
+}
+
+CAN_INFO SENSOR_CAN_INFO_ARRAY[] = {
+	{
+		IMU,
+		&imu_send_isr,
+		&imu_receive_isr
+	}
+};
+
+TESTING PROJECT MAIN FUNCTION EXAMPLE
+
+void main(void){
+
+	Uint32 test_data[] = {1,2,3};
+
+	CAN_init(SENSOR_CAN_INFO_ARRAY, 1, 1); // Initialize CAN with interrupts.
+
+	CAN_receive(PEDALS, 12, 4, 0);
+	CAN_send(test_data, 12, PEDALS); // Two frames, out of mailboxes 24-31
+
+	CAN_autoreply(test_data, 2, PEDALS, 4, 0);
+	CAN_request(PEDALS, 7, 0, 0);
+
+
+	while(1);
+}*/
+
+
+
+char interruptsEnabled;
+/*
+@brief Initializes the CAN module
+ */
+
+void CAN_init(CAN_INFO* can_array, Uint32 can_length, char enableInterrupts){
+	interruptsEnabled = enableInterrupts;
+	struct ECAN_REGS ECanaShadow;
+	Uint16 IERShadow;
+	CAN_INFO_ARRAY = can_array;
+	CAN_ARRAY_LENGTH = can_length;
+
+	// Build the ID index once here so the ISR never has to search the array.
+	// Insertion sort: the array is short, and usually written in order already.
+	Uint32 i, j;
+	CAN_INFO* info;
+	CAN_INDEX_LENGTH = (can_length < CAN_MAX_INFO) ? can_length : CAN_MAX_INFO;
+	for (i=0; i<CAN_INDEX_LENGTH; i++){
+		info = &can_array[i];
+		for (j=i; j>0 && CAN_ID_INDEX[j-1]->ID > info->ID; j--){
+			CAN_ID_INDEX[j] = CAN_ID_INDEX[j-1];
+		}
+		CAN_ID_INDEX[j] = info;
+	}
+	for (i=0; i<CAN_MBOXES; i++){
+		CAN_MBOX_TABLE[i] = 0;
+	}
+	CAN_TX_COUNT = 0;
+	CAN_TX_BUSY = 0;
+	CAN_TX_DROPPED = 0;
+	CAN_STATUS = CAN_STATUS_CLEAR;
+	CAN_STATUS.backoff = CAN_BACKOFF_MIN;
+
+	// Step 1. Initialize System Control:
+	// PLL, WatchDog, enable Peripheral Clocks
+	// This function is found in the F2806x_SysCtrl.c file.
+	// Should be commented out in regular usage. For normal usage initializing the system should be done elsewhere not in the CAN code.
+	// For testing purposes this is uncommented to initialize the system.
+	//   InitSysCtrl();
+
+	// Step 2. Initialize GPIO:
+	// Configure CAN pins using GPIO regs here
+	// This function is found in F2806x_ECan.c
+	InitECanGpio();
+
+	if (enableInterrupts) {
+		// FOR MOTOR CONTROLLER: NO INTERRUPTS!
+		// Step 3. Clear all interrupts and initialize PIE vector table:
+		// Disable CPU interrupts
+		DINT;
+
+		// Disable CPU interrupts and clear all CPU interrupt flags
+		// Save interrupts that were previously enabled
+		IERShadow = IER;
+		IER = 0x0000;
+		IFR = 0x0000;
+
+		EALLOW;
+		//Direct ECANA1 interrupts to the proper isr
+		PieVectTable.ECAN1INTA = &ecan_isr;
+		//Direct ECANA0 interupts to proper isr
+		PieVectTable.ECAN0INTA = &ecan_isr;
+		EDIS;
+
+		// Enable the PIE Vector Table
+		PieCtrlRegs.PIECTRL.bit.ENPIE = 1;
+	}
+	EALLOW;
+	SysCtrlRegs.PCLKCR0.bit.ECANAENCLK = 1;      // eCAN-A
+	EDIS;
+
+	// Step 4. Initialize CAN module
+	InitECana();
+
+
+
+	if (enableInterrupts) {
+		EALLOW;
+		//Allow all mailboxes to send interrupts
+		ECanaRegs.CANMIM.all = 0xFFFFFFFF;
+		//Using level 1 CAN interrupts  for mboxes
+		ECanaRegs.CANMIL.all = 0xFFFFFFFF;
+		//From all system interrupts use warning level, error passive and bus-off
+		//Enable level 0, 1 interrupts
+		ECanaRegs.CANGIM.all = 0x00000703;
+
+		//CAN interrupts are part of IER 9
+		IER = IERShadow | M_INT9;
+
+		//Enable ECAN interrupt 0 in PIE
+		PieCtrlRegs.PIEIER9.bit.INTx5 = 1;
+		//Enable ECAN interrupt 1 in PIE
+		PieCtrlRegs.PIEIER9.bit.INTx6 = 1;
+	}
+
+	ECanaShadow.CANMC.all = ECanaRegs.CANMC.all;
+	ECanaShadow.CANMC.bit.STM = 0;    // Disable CAN self-test mode (0=off)
+	ECanaRegs.CANMC.all = ECanaShadow.CANMC.all;
+
+	CAN_tx_pool(CAN_TX_POOL_DEFAULT);
+
+	if (enableInterrupts) {
+		// Enable global Interrupts and higher priority real-time debug events:
+		EINT;   // Enable Global interrupt INTM
+		ERTM;   // Enable Global realtime interrupt DBGM
+	}
+	EDIS;
+}
+
+// @brief Reserve mailboxes for the transmit queue. CAN_init reserves CAN_TX_POOL_DEFAULT; call
+// this afterwards (with nothing queued) to choose others. Don't use them for anything else.
+void CAN_tx_pool(Uint32 mbox_mask){
+	struct ECAN_REGS ECanaShadow;
+
+	CAN_TX_POOL = mbox_mask;
+	CAN_TX_BUSY = 0;
+
+	ECanaShadow.CANMD.all = ECanaRegs.CANMD.all;
+	ECanaShadow.CANMD.all &= ~mbox_mask;// 0 for transmit
+	ECanaRegs.CANMD.all = ECanaShadow.CANMD.all;
+}
+
+/*
+ * @brief Bring CAN_STATUS up to date with CANES, CANTEC and CANREC, following the state down as
+ * far as bus-off. Getting back up from bus-off is up to CAN_error_poll, which knows the time.
+ * Call with interrupts off.
+ */
+static void CAN_error_check(void){
+	struct ECAN_REGS ECanaShadow;
+	CAN_BUS_STATE state;
+	Uint32 errors;
+
+	ECanaShadow.CANES.all = ECanaRegs.CANES.all;
+	errors = ECanaShadow.CANES.all & CAN_ES_ERRORS;
+	if(errors){
+		ECanaRegs.CANES.all = errors;
+		CAN_STATUS.ack_errors += ECanaShadow.CANES.bit.ACKE;
+		CAN_STATUS.stuff_errors += ECanaShadow.CANES.bit.SE;
+		CAN_STATUS.crc_errors += ECanaShadow.CANES.bit.CRCE;
+		CAN_STATUS.bit_errors += ECanaShadow.CANES.bit.BE | ECanaShadow.CANES.bit.SA1;
+		CAN_STATUS.form_errors += ECanaShadow.CANES.bit.FE;
+	}
+
+	CAN_STATUS.tec = ECanaRegs.CANTEC.bit.TEC;
+	CAN_STATUS.rec = ECanaRegs.CANREC.bit.REC;
+	if(CAN_STATUS.tec > CAN_STATUS.tec_peak){
+		CAN_STATUS.tec_peak = CAN_STATUS.tec;
+	}
+	if(CAN_STATUS.rec > CAN_STATUS.rec_peak){
+		CAN_STATUS.rec_peak = CAN_STATUS.rec;
+	}
+
+	if(CAN_STATUS.state >= CAN_BUS_OFF){
+		return;
+	}
+	if(ECanaShadow.CANES.bit.BO){
+		state = CAN_BUS_OFF;
+	}
+	else if(ECanaShadow.CANES.bit.EP){
+		state = CAN_ERROR_PASSIVE;
+	}
+	else if(ECanaShadow.CANES.bit.EW){
+		state = CAN_ERROR_WARNING;
+	}
+	else{
+		state = CAN_ERROR_ACTIVE;
+	}
+
+	// Count every level passed on the way down
+	if(CAN_STATUS.state < CAN_ERROR_WARNING && state >= CAN_ERROR_WARNING){
+		CAN_STATUS.warnings++;
+	}
+	if(CAN_STATUS.state < CAN_ERROR_PASSIVE && state >= CAN_ERROR_PASSIVE){
+		CAN_STATUS.passives++;
+	}
+	if(state == CAN_BUS_OFF){
+		CAN_STATUS.bus_offs++;
+		CAN_OFF_TIMED = 0;
+		EALLOW;
+		ECanaRegs.CANMC.bit.CCR = 1; // Stay off until CAN_error_poll says otherwise
+		EDIS;
+	}
+	CAN_STATUS.state = state;
+}
+
+/*
+ * @brief Track the bus error state and get back on the bus after a bus-off. Call every few ms
+ * (from the main loop or a timer) with the time in ms; without it a bus-off is for good.
+ *
+ * After a bus-off the controller is held off for CAN_STATUS.backoff ms, then let back on, which
+ * takes another 128 x 11 bit times of quiet bus. A bus-off within CAN_BACKOFF_RESET ms of the last
+ * recovery doubles the backoff (up to CAN_BACKOFF_MAX), so a short that keeps coming back doesn't
+ * have us hammering the bus with error frames. Frames already in mailboxes go out once back on;
+ * the transmit queue keeps taking frames until it is full.
+ * @return The state now
+ */
+CAN_BUS_STATE CAN_error_poll(Uint32 now){
+	CAN_BUS_STATE state;
+	CAN_LOCK();
+
+	CAN_error_check();
+	if(CAN_STATUS.state == CAN_BUS_OFF){
+		if(!CAN_OFF_TIMED){
+			CAN_OFF_TIMED = 1;
+			CAN_STATUS.off_since = now;
+			if(CAN_STATUS.recoveries && now - CAN_STATUS.on_since < CAN_BACKOFF_RESET){
+				CAN_STATUS.backoff *= 2;
+				if(CAN_STATUS.backoff > CAN_BACKOFF_MAX){
+					CAN_STATUS.backoff = CAN_BACKOFF_MAX;
+				}
+			}
+			else{
+				CAN_STATUS.backoff = CAN_BACKOFF_MIN;
+			}
+		}
+		if(now - CAN_STATUS.off_since >= CAN_STATUS.backoff){
+			EALLOW;
+			ECanaRegs.CANMC.bit.CCR = 0;
+			EDIS;
+			CAN_STATUS.state = CAN_RECOVERING;
+		}
+	}
+	else if(CAN_STATUS.state == CAN_RECOVERING){
+		if(!ECanaRegs.CANES.bit.BO && !ECanaRegs.CANES.bit.CCE){
+			CAN_STATUS.state = CAN_ERROR_ACTIVE; // Counters are reset by the recovery
+			CAN_STATUS.recoveries++;
+			CAN_STATUS.on_since = now;
+		}
+	}
+	state = CAN_STATUS.state;
+
+	CAN_UNLOCK();
+	return state;
+}
+
+/*
+ * @brief An ID's place in arbitration, lowest first: the 11 base bits, then standard before
+ * extended (a standard frame's RTR and IDE bits are dominant where an extended one's SRR and IDE
+ * are recessive), then the 18 extended bits.
+ */
+static Uint32 CAN_priority(CAN_ID ID){
+	if (CAN_IS_EXT(ID)){
+		return (((Uint32)ID & 0x1FFC0000) << 1) | 0x00040000 | ((Uint32)ID & 0x0003FFFF);
+	}
+	return ((Uint32)ID & CAN_STD_MASK) << 19;
+}
+
+// @brief Is frame a (queued as number a_seq) before frame b? In bus priority order, then first
+// come first served.
+static int CAN_tx_ahead(CAN_ID a, Uint32 a_seq, CAN_ID b, Uint32 b_seq){
+	if (a != b){
+		return CAN_priority(a) < CAN_priority(b);
+	}
+	return (int32)(a_seq - b_seq) < 0;
+}
+
+// @brief Is a before b in the transmit queue?
+static int CAN_tx_before(CAN_TX_ENTRY* a, CAN_TX_ENTRY* b){
+	return CAN_tx_ahead(a->frame.ID, a->seq, b->frame.ID, b->seq);
+}
+
+// @brief Add one frame to the transmit queue and start it if a mailbox is free. Never waits.
+// Returns 1, or 0 if the queue was full and the frame was dropped.
+Uint16 CAN_queue(CAN_FRAME* frame){
+	CAN_TX_ENTRY entry;
+	Uint16 i, parent;
+	CAN_LOCK();
+
+	if (CAN_TX_COUNT >= CAN_TX_QUEUE_SIZE){
+		CAN_TX_DROPPED++;
+		CAN_UNLOCK();
+		return 0;
+	}
+	entry.frame = *frame;
+	entry.seq = CAN_TX_SEQ++;
+
+	// Sift up
+	i = CAN_TX_COUNT++;
+	while (i > 0){
+		parent = (i - 1) >> 1;
+		if (!CAN_tx_before(&entry, &CAN_TX_HEAP[parent])){
+			break;
+		}
+		CAN_TX_HEAP[i] = CAN_TX_HEAP[parent];
+		i = parent;
+	}
+	CAN_TX_HEAP[i] = entry;
+
+	CAN_tx_fill();
+	CAN_UNLOCK();
+	return 1;
+}
+
+//@brief Data must be array of {Lower 4 bytes, Higher 4 bytes, etc}
+//Queues length bytes as consecutive 8-byte frames with the same ID. They leave in order, but
+//nothing at the other end can tell them apart; use the transport layer for anything longer than 8.
+//Length is in units of bytes.
+//Returns the number of frames queued: all of them, or 0 if there wasn't room for all of them.
+//	Ex: PEDALS sends out 4 bytes of data
+//	CAN_send(data_array_pointer, 4, PEDALS);
+Uint16 CAN_send(Uint32* data, int length, CAN_ID ID){
+	CAN_FRAME frame;
+	Uint16 numFrames = (length + 7) / 8;
+	Uint16 i;
+	CAN_LOCK(); // So the frames go in together or not at all
+
+	if (numFrames > CAN_TX_QUEUE_SIZE - CAN_TX_COUNT){
+		CAN_TX_DROPPED += numFrames;
+		CAN_UNLOCK();
+		return 0;
+	}
+	frame.ID = ID;
+	for (i=0; i<numFrames; i++){
+		frame.length = (length >= 8) ? 8 : length;
+		frame.dataL = data[2*i];
+		frame.dataH = (length > 4) ? data[2*i+1] : 0;
+		length -= 8;
+		CAN_queue(&frame);
+	}
+	CAN_UNLOCK();
+	return numFrames;
+}
+
+// @brief Frames queued or on their way out
+Uint16 CAN_tx_pending(void){
+	Uint32 busy = CAN_TX_BUSY;
+	Uint16 n = CAN_TX_COUNT;
+
+	while (busy){
+		n += busy & 1;
+		busy >>= 1;
+	}
+	return n;
+}
+
+// @brief Remove the head of the transmit queue into *head. Call with interrupts off.
+static void CAN_tx_pop(CAN_TX_ENTRY* head){
+	CAN_TX_ENTRY last;
+	Uint16 i, child;
+
+	*head = CAN_TX_HEAP[0];
+	last = CAN_TX_HEAP[--CAN_TX_COUNT];
+
+	// Sift down
+	i = 0;
+	while ((child = 2*i + 1) < CAN_TX_COUNT){
+		if (child + 1 < CAN_TX_COUNT && CAN_tx_before(&CAN_TX_HEAP[child + 1], &CAN_TX_HEAP[child])){
+			child++;
+		}
+		if (!CAN_tx_before(&CAN_TX_HEAP[child], &last)){
+			break;
+		}
+		CAN_TX_HEAP[i] = CAN_TX_HEAP[child];
+		i = child;
+	}
+	CAN_TX_HEAP[i] = last;
+}
+
+// @brief Give each loaded pool mailbox a TPL from its frame's place among those loaded: the first
+// to go gets 31, the next 30, and so on. The eCAN sends the highest TPL first, and between equal
+// TPLs the highest-numbered mailbox, which has nothing to do with the queue's order, so no two
+// may be equal. TPL is looked at afresh for every arbitration, so waiting mailboxes can be
+// re-ranked when a more urgent frame joins them.
+static void CAN_tx_rank(void){
+	volatile struct MBOX *Mailbox;
+	Uint32 busy = CAN_TX_BUSY;
+	Uint16 i, j, rank;
+
+	for (i=0; i<CAN_MBOXES; i++){
+		if (!(busy & ((Uint32)1 << i))){
+			continue;
+		}
+		rank = 0;
+		for (j=0; j<CAN_MBOXES; j++){
+			if ((busy & ((Uint32)1 << j)) && CAN_tx_ahead(CAN_TX_INFLIGHT[j], CAN_TX_INFLIGHT_SEQ[j],
+					CAN_TX_INFLIGHT[i], CAN_TX_INFLIGHT_SEQ[i])){
+				rank++;
+			}
+		}
+		Mailbox = &ECanaMboxes.MBOX0 + i;
+		if (Mailbox->MSGCTRL.bit.TPL != 31 - rank){
+			Mailbox->MSGCTRL.bit.TPL = 31 - rank;
+		}
+	}
+}
+
+// @brief Load the queue into free pool mailboxes, then rank everything loaded. Call with
+// interrupts off. Frames reach the mailboxes in queue order, and CAN_tx_rank keeps them leaving in
+// it, even when a more urgent frame arrives after less urgent ones were loaded.
+static void CAN_tx_fill(void){
+	struct ECAN_REGS ECanaShadow;
+	volatile struct MBOX *Mailbox;
+	CAN_TX_ENTRY entry;
+	CAN_FRAME frame;
+	Uint32 free_mask, mask, loaded = 0;
+	Uint16 mbox_num;
+
+	while (CAN_TX_COUNT){
+		free_mask = CAN_TX_POOL & ~CAN_TX_BUSY;
+		if (!free_mask){
+			break;
+		}
+		for (mbox_num=CAN_MBOXES-1; !(free_mask & ((Uint32)1 << mbox_num)); mbox_num--);
+		mask = (Uint32)1 << mbox_num;
+		CAN_tx_pop(&entry);
+		frame = entry.frame;
+
+		Mailbox = &ECanaMboxes.MBOX0 + mbox_num;
+
+		// ECanaRegs.CANME.all &= ~mask; //Disable the mailbox to change its ID
+		ECanaShadow.CANME.all = ECanaRegs.CANME.all;
+		ECanaShadow.CANME.all &= ~mask;
+		ECanaRegs.CANME.all = ECanaShadow.CANME.all;
+
+		Mailbox->MSGID.all = CAN_encode_id(frame.ID);
+
+		ECanaShadow.CANME.all = ECanaRegs.CANME.all;
+		ECanaShadow.CANME.all |= mask;
+		ECanaRegs.CANME.all = ECanaShadow.CANME.all;
+
+		Mailbox->MSGCTRL.all = 0;
+		Mailbox->MSGCTRL.bit.DLC = frame.length;
+		Mailbox->MDL.all = frame.dataL;
+		Mailbox->MDH.all = frame.dataH;
+
+		CAN_TX_INFLIGHT[mbox_num] = frame.ID;
+		CAN_TX_INFLIGHT_SEQ[mbox_num] = entry.seq;
+		CAN_TX_BUSY |= mask;
+		CAN_MBOX_TABLE[mbox_num] = CAN_find(frame.ID);
+		loaded |= mask;
+	}
+	if (loaded){
+		CAN_tx_rank(); // Before any of the new ones can start
+		ECanaRegs.CANTRS.all = loaded; // Writing 0s does nothing, so no need to read first
+	}
+}
+
+// @brief Hand back pool mailboxes whose frames have gone and refill them. The ISR does this by
+// itself; without interrupts, call it from the main loop.
+void CAN_tx_poll(void){
+	Uint32 done;
+	Uint16 i;
+	CAN_LOCK();
+
+	done = ECanaRegs.CANTA.all & CAN_TX_BUSY;
+	if (done){
+		ECanaRegs.CANTA.all = done; // Clear TA bits by writing 1
+		CAN_TX_BUSY &= ~done;
+		for (i=0; CAN_tx_hook && i<CAN_MBOXES; i++){
+			if (done & ((Uint32)1 << i)){
+				CAN_tx_hook(CAN_TX_INFLIGHT[i]);
+			}
+		}
+		CAN_tx_fill();
+	}
+	CAN_UNLOCK();
+}
+
+/*
+ * @brief Configure mailboxes to receive *length* bytes from desired CAN ID
+ * If mailbox number exceeds 31, then it will wrap around starting at 0.
+ */
+void CAN_receive(CAN_ID ID, int length, Uint32 mbox_num, char block){
+	struct ECAN_REGS ECanaShadow;
+	volatile struct MBOX *Mailbox;
+
+	//How many mailboxes need to be used?
+	Uint32 numMbox;
+	if(length%8){
+		numMbox = length/8 + 1;
+	}
+	else{
+		numMbox = length/8;
+	}
+
+	Uint32 bitMaskOfOnes = (((Uint32)1 << (numMbox)) - (Uint32)1) << (mbox_num);
+
+	//ECanaRegs.CANME.all &= ~mbox_mask; //Disable the mailboxes to modify their content
+	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
+	ECanaShadow.CANME.all &= ~bitMaskOfOnes;
+	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
+
+	//ECanaRegs.CANMD.all |= mbox_mask; //Configure mailbox for receive
+	ECanaShadow.CANMD.all = ECanaRegs.CANMD.all;
+	ECanaShadow.CANMD.all |= bitMaskOfOnes;
+	ECanaRegs.CANMD.all = ECanaShadow.CANMD.all;
+
+	Uint32 i;
+	for (i=0; i< numMbox; i++){
+		// Construct pointer to the correct mailbox register.
+		// Starts off from mailbox 0 and increments from there.
+		Mailbox = &ECanaMboxes.MBOX0 + ((i + mbox_num) % 32);
+
+		if(length >= 8){
+			Mailbox->MSGCTRL.bit.DLC = 8;
+			length -= 8;
+		}
+		else{
+			Mailbox->MSGCTRL.bit.DLC = length;
+		}
+
+		Mailbox->MSGID.all = CAN_encode_id(ID); // Sets IDE for extended IDs
+		Mailbox->MSGID.bit.AAM = 0;
+		Mailbox->MSGID.bit.AME = 0;
+	}
+	CAN_bind(bitMaskOfOnes, ID);
+
+	//ECanaRegs.CANME.all |= mbox_mask; //Enable the mailboxes
+	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
+	ECanaShadow.CANME.all |= bitMaskOfOnes;
+	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
+
+	if(block){
+		while(ECanaRegs.CANRMP.all ^ bitMaskOfOnes ){}
+	}
+}
+// @brief How many IDs a filter lets in that nobody asked for.
+static Uint32 CAN_filter_waste(Uint32 mask, Uint16 members){
+	Uint32 accepted = 1;
+
+	while (mask){
+		accepted <<= (mask & 1); // Each don't-care bit doubles what gets in
+		mask >>= 1;
+	}
+	return accepted - members;
+}
+
+/*
+ * @brief Group a set of IDs into as few acceptance filters (ID + LAM mask pairs) as possible.
+ * Filters that let in nothing extra are always merged, e.g. 0x100 and 0x101 become 0x100 with bit 0
+ * don't-care. Then, while there are still more filters than max_filters, the pair whose merge lets
+ * in the fewest unwanted IDs is merged. Frames with unwanted IDs still interrupt the CPU; ecan_isr
+ * drops them because they have no CAN_INFO. Standard and extended IDs are never merged, so given
+ * both kinds it may need one filter more than max_filters.
+ * filters must have room for n entries; it is used as scratch. Returns the number of filters.
+ */
+Uint16 CAN_plan_filters(const CAN_ID* ids, Uint16 n, CAN_FILTER* filters, Uint16 max_filters){
+	Uint16 count = 0;
+	Uint16 i, j, k, best_i, best_j;
+	Uint32 mask, ID, waste, best_waste;
+
+	for (i=0; i<n; i++){
+		for (j=0; j<count && filters[j].ID != (Uint32)ids[i]; j++);
+		if (j == count){ // Skip repeats
+			filters[count].ID = (Uint32)ids[i];
+			filters[count].mask = 0;
+			filters[count].members = 1;
+			filters[count].mbox_num = 0;
+			count++;
+		}
+	}
+
+	while (count > 1){
+		best_i = best_j = 0;
+		best_waste = 0xFFFFFFFF;
+		for (i=0; i<count; i++){
+			for (j=i+1; j<count; j++){
+				mask = filters[i].mask | filters[j].mask | (filters[i].ID ^ filters[j].ID);
+				if (mask & CAN_EXT){
+					continue; // One standard, one extended: no mailbox takes both
+				}
+				waste = CAN_filter_waste(mask, filters[i].members + filters[j].members);
+				if (waste < best_waste){
+					best_waste = waste;
+					best_i = i;
+					best_j = j;
+				}
+			}
+		}
+		if ((best_waste && count <= max_filters) || best_waste == 0xFFFFFFFF){
+			break;
+		}
+
+		// Merge j into i, then let i swallow any other filter it now covers
+		mask = filters[best_i].mask | filters[best_j].mask | (filters[best_i].ID ^ filters[best_j].ID);
+		ID = filters[best_i].ID & ~mask;
+		filters[best_i].ID = ID;
+		filters[best_i].mask = mask;
+		filters[best_i].members += filters[best_j].members;
+		filters[best_j] = filters[--count];
+		for (k=0; k<count; k++){
+			if (k != best_i && !(filters[k].mask & ~mask) && (filters[k].ID & ~mask) == ID){
+				filters[best_i].members += filters[k].members;
+				filters[k] = filters[--count];
+				if (best_i == count){
+					best_i = k;
+				}
+				k--;
+			}
+		}
+	}
+	return count;
+}
+
+/*
+ * @brief Receive every ID in ids, using as few of the mailboxes in mbox_mask as the acceptance masks
+ * allow. Mailboxes are handed out from the lowest number up; by default, leave out the transmit pool
+ * by passing CAN_RX_POOL_DEFAULT. If filters isn't 0, the plan is copied there (room for n entries).
+ * Returns the number of mailboxes used, or 0 if there were no IDs or no mailboxes.
+ */
+Uint16 CAN_receive_filtered(const CAN_ID* ids, Uint16 n, Uint32 mbox_mask, CAN_FILTER* filters){
+	static CAN_FILTER plan[CAN_FILTER_MAX_IDS];
+	struct ECAN_REGS ECanaShadow;
+	volatile struct MBOX *Mailbox;
+	Uint16 available = 0;
+	Uint16 count, i, mbox_num;
+	Uint32 used = 0;
+
+	for (i=0; i<CAN_MBOXES; i++){
+		available += (mbox_mask >> i) & 1;
+	}
+	if (n > CAN_FILTER_MAX_IDS){
+		n = CAN_FILTER_MAX_IDS;
+	}
+	if (n == 0 || available == 0){
+		return 0;
+	}
+	count = CAN_plan_filters(ids, n, plan, available);
+	if (count > available){
+		count = available; // Only if both kinds of ID were asked for with a single mailbox
+	}
+
+	mbox_num = 0;
+	for (i=0; i<count; i++){
+		while (!(mbox_mask & ((Uint32)1 << mbox_num))){
+			mbox_num++;
+		}
+		plan[i].mbox_num = mbox_num;
+		used |= (Uint32)1 << mbox_num;
+		mbox_num++;
+	}
+
+	//ECanaRegs.CANME.all &= ~used; //Disable the mailboxes to modify their content
+	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
+	ECanaShadow.CANME.all &= ~used;
+	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
+
+	//ECanaRegs.CANMD.all |= used; //Configure mailboxes for receive
+	ECanaShadow.CANMD.all = ECanaRegs.CANMD.all;
+	ECanaShadow.CANMD.all |= used;
+	ECanaRegs.CANMD.all = ECanaShadow.CANMD.all;
+
+	for (i=0; i<count; i++){
+		Mailbox = &ECanaMboxes.MBOX0 + plan[i].mbox_num;
+		Mailbox->MSGCTRL.all = 0;
+		Mailbox->MSGCTRL.bit.DLC = 8;
+		Mailbox->MSGID.all = CAN_encode_id((CAN_ID)plan[i].ID);
+		Mailbox->MSGID.bit.AAM = 0;
+		Mailbox->MSGID.bit.AME = 1; // Compare only the bits LAM doesn't mask out
+		// LAMI = 0: only frames of the mailbox's own kind (IDE) get in
+		(&ECanaLAMRegs.LAM0)[plan[i].mbox_num].all = CAN_IS_EXT(plan[i].ID) ? (plan[i].mask & CAN_EXT_MASK) : (plan[i].mask << 18);
+		CAN_MBOX_TABLE[plan[i].mbox_num] = CAN_find((CAN_ID)plan[i].ID); // Exact only if alone; ecan_isr searches otherwise
+		if (filters){
+			filters[i] = plan[i];
+		}
+	}
+
+	//ECanaRegs.CANME.all |= used; //Enable the mailboxes
+	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
+	ECanaShadow.CANME.all |= used;
+	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
+
+	return count;
+}
+
+/*
+ * @brief Request data from specified mailbox
+ * length is in bytes
+ */
+void CAN_request(CAN_ID ID, int length, Uint32 mbox_num, char block){
+	struct ECAN_REGS ECanaShadow;
+	volatile struct MBOX *Mailbox;
+
+	// How many mailboxes need to be used?
+	Uint32 numMbox;
+	if(length%8){
+		numMbox = length/8 + 1;
+	}
+	else{
+		numMbox = length/8;
+	}
+
+	Uint32 bitMaskOfOnes = (((Uint32)1 << (numMbox)) - (Uint32)1) << (mbox_num);
+
+	//ECanaRegs.CANME.all &= ~mbox_mask; //Disable the mailboxes to modify their content
+	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
+	ECanaShadow.CANME.all &= ~bitMaskOfOnes;
+	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
+
+	//ECanaRegs.CANMD.all |= mbox_mask; //Configure mailbox for receive
+	ECanaShadow.CANMD.all = ECanaRegs.CANMD.all;
+	ECanaShadow.CANMD.all |= bitMaskOfOnes;
+	ECanaRegs.CANMD.all = ECanaShadow.CANMD.all;
+
+	Uint32 i;
+	for (i=0; i< numMbox; i++){
+		// Construct pointer to the correct mailbox register.
+		// Starts off from mailbox 0 and increments from there.
+		Mailbox = &ECanaMboxes.MBOX0 + ((i + mbox_num) % 32);
+
+		if(length >= 8){
+			Mailbox->MSGCTRL.bit.DLC = 8;
+			length -= 8;
+		}
+		else{
+			Mailbox->MSGCTRL.bit.DLC = length;
+		}
+		Mailbox->MSGCTRL.bit.RTR = 1;// Set request flag
+
+		Mailbox->MSGID.all = CAN_encode_id(ID); // Sets IDE for extended IDs
+		Mailbox->MSGID.bit.AAM = 0;
+		Mailbox->MSGID.bit.AME = 0;
+	}
+	CAN_bind(bitMaskOfOnes, ID);
+
+	//ECanaRegs.CANME.all |= mbox_mask; // Enable the mailboxes
+	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
+	ECanaShadow.CANME.all |= bitMaskOfOnes;
+	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
+
+	//ECanaRegs.CANTRS.all |= mbox_mask;// Request!
+	ECanaShadow.CANTRS.all = ECanaRegs.CANTRS.all;
+	ECanaShadow.CANTRS.all |= bitMaskOfOnes;
+	ECanaRegs.CANTRS.all = ECanaShadow.CANTRS.all;
+
+	if(block){
+		while(ECanaRegs.CANTA.all != ~bitMaskOfOnes ) {}  // Wait for all TAn bits to be set..
+	}
+}
+
+// @brief Set up a mailbox to automatically send data upon request. Length in bytes.
+
+void CAN_autoreply(Uint32* data, int length, CAN_ID ID, Uint32 mbox_num, char block){
+	struct ECAN_REGS ECanaShadow;
+	volatile struct MBOX *Mailbox;
+
+	// How many mailboxes need to be used?
+	Uint32 numMbox;
+	if(length%8) {
+		numMbox = length/8 + 1;
+	} else {
+		numMbox = length/8;
+	}
+
+	Uint32 bitMaskOfOnes = (((Uint32)1 << (numMbox)) - (Uint32)1) << (mbox_num);
+
+	//ECanaRegs.CANTRR.all |= bitMaskOfOnes; //Clear TRS bits
+	ECanaShadow.CANTRR.all = ECanaRegs.CANTRR.all;
+	ECanaShadow.CANTRR.all |= bitMaskOfOnes;
+	ECanaRegs.CANTRR.all = ECanaShadow.CANTRR.all;
+
+	while(ECanaRegs.CANTRS.all & bitMaskOfOnes); //Wait until TRS bits are cleared
+
+	//ECanaRegs.CANME.all &= ~bitMaskOfOnes; //Disable the mailboxes to modify their content
+	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
+	ECanaShadow.CANME.all &= ~bitMaskOfOnes;
+	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
+
+	//ECanaRegs.CANMD.all &= ~bitMaskOfOnes; //Configure mailboxes for transmit
+	ECanaShadow.CANMD.all = ECanaRegs.CANMD.all;
+	ECanaShadow.CANMD.all &= ~bitMaskOfOnes;
+	ECanaRegs.CANMD.all = ECanaShadow.CANMD.all;
+
+	int i;
+	for (i=0; i< numMbox; i++){
+		Mailbox = &ECanaMboxes.MBOX0 + i + mbox_num;
+
+		if(length >= 8){
+			Mailbox->MSGCTRL.bit.DLC = 8;
+			length -= 8;
+		}
+		else{
+			Mailbox->MSGCTRL.bit.DLC = length;
+		}
+		Mailbox->MDL.all = data[2*i];
+
+		// Make sure that the next data array value exists
+		if(length >= 0) {
+			Mailbox->MDH.all = data[2*i+1];
+		}
+		else {
+			Mailbox->MDH.all = 0;
+		}
+
+		Mailbox->MSGID.all = CAN_encode_id(ID); // Sets IDE for extended IDs, as a remote frame must match
+		Mailbox->MSGID.bit.AAM = 1; // Auto answer mode is on
+		Mailbox->MSGID.bit.AME = 0;
+	}
+	CAN_bind(bitMaskOfOnes, ID);
+
+	//ECanaRegs.CANME.all |= bitMaskOfOnes; //Enable the mailboxes
+	ECanaShadow.CANME.all = ECanaRegs.CANME.all;
+	ECanaShadow.CANME.all |= bitMaskOfOnes;
+	ECanaRegs.CANME.all = ECanaShadow.CANME.all;
+
+	if(block){
+		while(ECanaRegs.CANTA.all != ~bitMaskOfOnes ) {}  // Wait for all TAn bits to be set..
+	}
+}
+
+/*
+ * @brief Find the CAN_INFO for an ID by binary search of CAN_ID_INDEX. Returns 0 if there is none.
+ */
+CAN_INFO* CAN_find(CAN_ID ID){
+	Uint32 lo = 0;
+	Uint32 hi = CAN_INDEX_LENGTH;
+	Uint32 mid;
+
+	while (lo < hi){
+		mid = (lo + hi) >> 1;
+		if (CAN_ID_INDEX[mid]->ID < ID){
+			lo = mid + 1;
+		}
+		else{
+			hi = mid;
+		}
+	}
+	if (lo < CAN_INDEX_LENGTH && CAN_ID_INDEX[lo]->ID == ID){
+		return CAN_ID_INDEX[lo];
+	}
+	return 0;
+}
+
+// @brief The MSGID register bits (ID and IDE) for an ID. AME and AAM are left 0.
+Uint32 CAN_encode_id(CAN_ID ID){
+	if (CAN_IS_EXT(ID)){
+		return ((Uint32)ID & CAN_EXT_MASK) | CAN_EXT; // The 29 bits go in as they are, and IDE is bit 31 too
+	}
+	return ((Uint32)ID & CAN_STD_MASK) << 18; // STDMSGID
+}
+
+// @brief The ID in a MSGID register value
+CAN_ID CAN_decode_id(Uint32 msgid){
+	if (msgid & CAN_EXT){ // IDE
+		return (CAN_ID)((msgid & CAN_EXT_MASK) | CAN_EXT);
+	}
+	return (CAN_ID)((msgid >> 18) & CAN_STD_MASK);
+}
+
+// @brief Record which CAN_INFO owns the given mailboxes, so the ISR can go straight to it.
+static void CAN_bind(Uint32 mbox_mask, CAN_ID ID){
+	CAN_INFO* info = CAN_find(ID);
+	Uint16 i;
+
+	for (i=0; i<CAN_MBOXES; i++){
+		if (mbox_mask & ((Uint32)1 << i)){
+			CAN_MBOX_TABLE[i] = info;
+		}
+	}
+}
+
+//@brief Based on the the event which triggered the interrupt (sent or received), calls the user specified function
+//
+//Constant time: the mailbox number comes straight from MIV1 and indexes CAN_MBOX_TABLE. Only if the
+//frame's ID doesn't belong to that mailbox's owner does it fall back to CAN_find. Nothing in here may
+//block or print; bus errors only update CAN_STATUS, and CAN_error_poll does the rest.
+
+//checks what threw the interrupt (after a send or receive)
+__interrupt void ecan_isr(void){
+	//Extract mailbox number, CAN ID, data, execute desired user function
+	struct ECAN_REGS ECanaShadow;
+
+	ECanaShadow.CANGIF0.all = ECanaRegs.CANGIF0.all;
+	if(ECanaShadow.CANGIF0.bit.BOIF0 || ECanaShadow.CANGIF0.bit.EPIF0 || ECanaShadow.CANGIF0.bit.WLIF0){
+		EALLOW;
+		ECanaRegs.CANGIF0.all = ECanaShadow.CANGIF0.all & 0x00000700; // Clear the flags by writing 1
+		EDIS;
+		// Don't clear CCR here: if the bus is still broken that only puts us straight back into
+		// bus-off, over and over. CAN_error_poll clears it after the backoff.
+		CAN_error_check();
+	}
+	else{
+		Uint32 ID;
+		volatile struct MBOX *Mailbox;
+		CAN_INFO* info;
+
+		//Determine which mailbox generated the interrupt
+		Uint16 mbox_num = ECanaRegs.CANGIF1.bit.MIV1;
+		Mailbox = &ECanaMboxes.MBOX0 + mbox_num;
+		Uint32 mbox_mask = (Uint32) 1 << (Uint32) mbox_num;
+
+		ID = CAN_decode_id(Mailbox->MSGID.all); // The ID received, if the mailbox filters with a mask
+		info = CAN_MBOX_TABLE[mbox_num];
+		if(info == 0 || info->ID != (CAN_ID)ID){
+			info = CAN_find((CAN_ID)ID);
+		}
+
+		if(ECanaRegs.CANTA.all & mbox_mask){ //If TA bit is set
+			if(info && info->upon_sent_isr){
+				info->upon_sent_isr(info->ID, Mailbox->MDH.all, Mailbox->MDL.all, Mailbox->MSGCTRL.bit.DLC, mbox_num);
+			}
+			ECanaRegs.CANTA.all = mbox_mask; //Clear TA bit by writing 1 (only this one; |= would clear them all)
+			if(CAN_TX_BUSY & mbox_mask){ //A queue mailbox is free again: give it the next frame
+				CAN_TX_BUSY &= ~mbox_mask;
+				if(CAN_tx_hook){
+					CAN_tx_hook(CAN_TX_INFLIGHT[mbox_num]);
+				}
+				CAN_tx_fill();
+			}
+		}
+		else if(ECanaRegs.CANRMP.all & mbox_mask){ //If RMP bit is set
+			if(CAN_rx_hook){
+				CAN_rx_hook(mbox_num);
+			}
+			if(info && info->upon_receive_isr){
+				info->upon_receive_isr(info->ID, Mailbox->MDH.all, Mailbox->MDL.all, Mailbox->MSGCTRL.bit.DLC, mbox_num);
+			}
+			ECanaRegs.CANRMP.all = mbox_mask; //Clear RMP bit by writing 1, handled or not, or it will fire forever
+		}
+	}
+	PieCtrlRegs.PIEACK.bit.ACK9 = 1; //Acknowledge interrupt
+}
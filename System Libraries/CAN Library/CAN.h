@@ -1,24 +1,104 @@
-typedef enum{
-	MOTOR_CONTROLLER,
-	PEDALS,
-	BMS,
-	IMU,
-	WIFI,
-	SCREEN,
-	MPPT=0x600
-	//Number of CAN nodes must be less than 2^29! Not going to be a problem...ever
-} CAN_ID;
-
-#include "F2806x_Cla_typedefs.h"
-typedef struct{
-	CAN_ID ID;
-	void (*upon_sent_isr)(CAN_ID ID, Uint32 dataH, Uint32 dataL, Uint16 length, int mbox_num);
-	void (*upon_receive_isr)(CAN_ID ID, Uint32 dataH, Uint32 dataL, Uint16 length, int mbox_num);
-}CAN_INFO;
-
-void CAN_send(Uint32* data, int length, CAN_ID ID, Uint32 mbox_num, char block);
-void CAN_receive(CAN_ID ID, int length, Uint32 mbox_num, char block);
-void CAN_request(CAN_ID ID, int length, Uint32 mbox_num, char block);
-void CAN_autoreply(Uint32* data, int length, CAN_ID ID, Uint32 mbox_num, char block);
-void CAN_init(CAN_INFO* can_array, Uint32 can_length, char enableInterrupts);
-
+#ifndef CAN_H_
+#define CAN_H_
+
+// IDs are 11-bit standard ones unless CAN_EXT is set, when they are 29-bit extended ones (the same
+// flag .dbc files use). Everything that takes a CAN_ID takes either kind.
+#define CAN_EXT 0x80000000
+#define CAN_STD_MASK 0x000007FF
+#define CAN_EXT_MASK 0x1FFFFFFF
+#define CAN_IS_EXT(ID) (((Uint32)(ID) & CAN_EXT) != 0)
+
+typedef enum{
+	MOTOR_CONTROLLER,
+	PEDALS,
+	BMS,
+	IMU,
+	WIFI,
+	SCREEN,
+	MPPT=0x600 | CAN_EXT
+	//Standard IDs must be less than 2^11, extended ones less than 2^29
+} CAN_ID;
+
+#include "F2806x_Cla_typedefs.h"
+typedef struct{
+	CAN_ID ID;
+	void (*upon_sent_isr)(CAN_ID ID, Uint32 dataH, Uint32 dataL, Uint16 length, int mbox_num);
+	void (*upon_receive_isr)(CAN_ID ID, Uint32 dataH, Uint32 dataL, Uint16 length, int mbox_num);
+}CAN_INFO;
+
+typedef struct{
+	CAN_ID ID;		// Standard, or extended with CAN_EXT
+	Uint16 length; // Bytes, 0-8
+	Uint32 dataL;
+	Uint32 dataH;
+}CAN_FRAME;
+
+// One hardware receive filter: frames whose ID matches ID in every bit not set in mask are accepted.
+// A filter takes only standard or only extended IDs, as CAN_EXT in ID says.
+typedef struct{
+	Uint32 ID;
+	Uint32 mask;		// 1 = don't care, as in the LAM registers
+	Uint16 members;		// How many of the requested IDs it covers
+	Uint16 mbox_num;
+}CAN_FILTER;
+
+// Where the controller stands with the bus, from its error counters (CAN 2.0B fault confinement)
+typedef enum{
+	CAN_ERROR_ACTIVE,	// TEC and REC below 96
+	CAN_ERROR_WARNING,	// Either at 96 or more
+	CAN_ERROR_PASSIVE,	// Either at 128 or more: error flags we send are recessive
+	CAN_BUS_OFF,		// TEC passed 255. Held off the bus until the backoff runs out
+	CAN_RECOVERING		// Back on, waiting for the 128 x 11 recessive bits the standard asks for
+}CAN_BUS_STATE;
+
+// Error counters, for telemetry. Read CAN_STATUS, or use CAN_error_poll's result.
+typedef struct{
+	CAN_BUS_STATE state;
+	Uint16 tec;				// Transmit and receive error counters, as of the last check
+	Uint16 rec;
+	Uint16 tec_peak;		// Highest seen
+	Uint16 rec_peak;
+	Uint32 warnings;		// Times the state got this bad (or worse) from better
+	Uint32 passives;
+	Uint32 bus_offs;
+	Uint32 recoveries;		// Times the bus was got back
+	Uint32 ack_errors;		// Checks that found each CANES error flag set. Lots of ack errors
+	Uint32 stuff_errors;	// with nothing else usually means nobody else is on the bus.
+	Uint32 crc_errors;
+	Uint32 bit_errors;
+	Uint32 form_errors;
+	Uint32 backoff;			// ms the current (or next) bus-off waits before trying again
+	Uint32 off_since;		// ms, when the last bus-off was first polled
+	Uint32 on_since;		// ms, when the last recovery finished
+}CAN_BUS_STATUS;
+
+#define CAN_MBOXES 32
+#define CAN_MAX_INFO 32 // Entries of the CAN_INFO array past this many are ignored
+#define CAN_TX_QUEUE_SIZE 32 // Frames waiting for a mailbox
+#define CAN_TX_POOL_DEFAULT 0xFF000000 // Mailboxes 24-31 transmit the queue
+#define CAN_RX_POOL_DEFAULT 0x00FFFFFF // Everything else
+#define CAN_FILTER_MAX_IDS 64 // IDs one CAN_receive_filtered call can take
+#define CAN_BACKOFF_MIN 10 // ms off the bus after a bus-off, doubling each time it happens again soon
+#define CAN_BACKOFF_MAX 2000
+#define CAN_BACKOFF_RESET 10000 // ms on the bus after which the backoff goes back to CAN_BACKOFF_MIN
+
+Uint16 CAN_send(Uint32* data, int length, CAN_ID ID);
+Uint16 CAN_queue(CAN_FRAME* frame);
+void CAN_tx_pool(Uint32 mbox_mask);
+void CAN_tx_poll(void);
+Uint16 CAN_tx_pending(void);
+extern void (*CAN_tx_hook)(CAN_ID ID);
+extern void (*CAN_rx_hook)(Uint16 mbox_num);
+void CAN_receive(CAN_ID ID, int length, Uint32 mbox_num, char block);
+Uint16 CAN_plan_filters(const CAN_ID* ids, Uint16 n, CAN_FILTER* filters, Uint16 max_filters);
+Uint16 CAN_receive_filtered(const CAN_ID* ids, Uint16 n, Uint32 mbox_mask, CAN_FILTER* filters);
+void CAN_request(CAN_ID ID, int length, Uint32 mbox_num, char block);
+void CAN_autoreply(Uint32* data, int length, CAN_ID ID, Uint32 mbox_num, char block);
+void CAN_init(CAN_INFO* can_array, Uint32 can_length, char enableInterrupts);
+CAN_INFO* CAN_find(CAN_ID ID);
+Uint32 CAN_encode_id(CAN_ID ID);
+CAN_ID CAN_decode_id(Uint32 msgid);
+CAN_BUS_STATE CAN_error_poll(Uint32 now);
+extern CAN_BUS_STATUS CAN_STATUS;
+
+#endif /* CAN_H_ */
@@ -1,69 +1,180 @@
-/*
- * CAN_formatting.c
- *
- *  Created on: Oct 25, 2014
- *      Author: Andrey
- */
-#include "CAN_formatting.h"
-#include <stdlib.h>
-
-typedef union ufloat {
-	float32 f;
-	Uint32 i;
-}ufloat;
-
-Uint32 combineChars(char last, char third, char second, char first){
-	Uint32 f = ((Uint32) first);
-	Uint32 s = ((Uint32) second) << 8;
-	Uint32 t = ((Uint32) third) << 16;
-	Uint32 l = ((Uint32) last) << 24;
-	return l|t|s|f;
-}
-
-Uint32 combineIntHalves(Uint16 dataH, Uint16 dataL){
-	Uint32 high = ((Uint32)dataH) << 16;
-	return high|dataL;
-}
-
-Uint32 convertFloat(float32 f){
-	ufloat convert;
-	convert.f = f;
-	return convert.i;
-}
-
-float32 convertInt(Uint32 i){
-	ufloat convert;
-	convert.i = i;
-	return convert.f;
-}
-
-Uint32* convertFloats(float32* floats, int length){
-	int i;
-	Uint32* ints=(Uint32*)malloc(4*length);
-	for(i=0;i<length;i++)
-		ints[i] = convertFloat(floats[i]);
-	return ints;
-}
-
-float32* convertInts(Uint32* ints, int length){
-	int i;
-	float32* floats=(float32*)malloc(4*length);
-	for(i=0;i<length;i++)
-		floats[i] = convertInt(ints[i]);
-	return floats;
-}
-
-Uint16 getFirstHalf(Uint32 v){
-	return (Uint16) (v & 0x0000FFFF);
-}
-
-Uint16 getSecondHalf(Uint32 v){
-	return (Uint16) (v >>16);
-}
-
-Uint32* putIntoBuffer(Uint32 DataH, Uint32 DataL){
-	Uint32 buffer[2];
-	buffer[0] = DataL;
-	buffer[1] = DataH;
-	return buffer;
-}
+/*
+ * CAN_formatting.c
+ *
+ *  Created on: Oct 25, 2014
+ *      Author: Andrey
+ */
+#include "CAN_formatting.h"
+
+typedef union ufloat {
+	float32 f;
+	Uint32 i;
+}ufloat;
+
+Uint32 combineChars(char last, char third, char second, char first){
+	Uint32 f = ((Uint32) first);
+	Uint32 s = ((Uint32) second) << 8;
+	Uint32 t = ((Uint32) third) << 16;
+	Uint32 l = ((Uint32) last) << 24;
+	return l|t|s|f;
+}
+
+Uint32 combineIntHalves(Uint16 dataH, Uint16 dataL){
+	Uint32 high = ((Uint32)dataH) << 16;
+	return high|dataL;
+}
+
+Uint32 convertFloat(float32 f){
+	ufloat convert;
+	convert.f = f;
+	return convert.i;
+}
+
+float32 convertInt(Uint32 i){
+	ufloat convert;
+	convert.i = i;
+	return convert.f;
+}
+
+// The caller owns ints; nothing is allocated. Returns ints for convenience.
+Uint32* convertFloats(float32* floats, Uint32* ints, int length){
+	int i;
+	for(i=0;i<length;i++)
+		ints[i] = convertFloat(floats[i]);
+	return ints;
+}
+
+// The caller owns floats. Returns floats.
+float32* convertInts(Uint32* ints, float32* floats, int length){
+	int i;
+	for(i=0;i<length;i++)
+		floats[i] = convertInt(ints[i]);
+	return floats;
+}
+
+Uint16 getFirstHalf(Uint32 v){
+	return (Uint16) (v & 0x0000FFFF);
+}
+
+Uint16 getSecondHalf(Uint32 v){
+	return (Uint16) (v >>16);
+}
+
+// buffer must have room for 2. (This used to return a local array, which was gone by the time
+// the caller looked at it.)
+Uint32* putIntoBuffer(Uint32 DataH, Uint32 DataL, Uint32* buffer){
+	buffer[0] = DataL;
+	buffer[1] = DataH;
+	return buffer;
+}
+
+/*
+ * Signals: values packed at arbitrary bit positions in the 8 data bytes, as a DBC file describes
+ * them. Byte 0 is the first on the wire, which with DBO = 0 is the top byte of MDL.
+ *
+ * Intel (little-endian) signals: start is the lsb, counting bit 0 of byte 0 as 0, bit 0 of byte 1
+ * as 8, ... so the payload reads as one little-endian 64-bit number.
+ * Motorola (big-endian) signals: start is the msb, numbered the same way (the DBC "sawtooth"), and
+ * the signal runs from there towards the lsb of later bytes, so the payload reads as one
+ * big-endian 64-bit number. That number is just MDL:MDH.
+ */
+
+// @brief Reverse the bytes of a word
+static Uint32 swapBytes(Uint32 v){
+	return (v >> 24) | ((v >> 8) & 0x0000FF00) | ((v << 8) & 0x00FF0000) | (v << 24);
+}
+
+// @brief Where the lsb of a signal sits in MDL:MDH (as one big-endian 64-bit number), or in its
+// byte-reversed twin for Intel signals.
+static Uint16 signalShift(const CAN_SIGNAL* sig){
+	if(sig->motorola)
+		return 63 - (((sig->start >> 3) << 3) + 7 - (sig->start & 7)) - (sig->length - 1);
+	return sig->start;
+}
+
+// @brief The raw bits of a signal. Reads only; dataL/dataH can come straight from a mailbox or ISR.
+Uint32 unpackBits(Uint32 dataL, Uint32 dataH, const CAN_SIGNAL* sig){
+	Uint64 payload;
+	Uint64 mask = ((Uint64)1 << sig->length) - 1;
+
+	if(sig->motorola)
+		payload = ((Uint64)dataL << 32) | dataH;
+	else
+		payload = ((Uint64)swapBytes(dataH) << 32) | swapBytes(dataL);
+	return (Uint32)((payload >> signalShift(sig)) & mask);
+}
+
+// @brief Write the raw bits of a signal, leaving the rest of the payload alone.
+void packBits(Uint32* dataL, Uint32* dataH, const CAN_SIGNAL* sig, Uint32 raw){
+	Uint64 payload;
+	Uint64 mask = ((Uint64)1 << sig->length) - 1;
+	Uint16 shift = signalShift(sig);
+
+	if(sig->motorola)
+		payload = ((Uint64)*dataL << 32) | *dataH;
+	else
+		payload = ((Uint64)swapBytes(*dataH) << 32) | swapBytes(*dataL);
+
+	payload = (payload & ~(mask << shift)) | (((Uint64)raw & mask) << shift);
+
+	if(sig->motorola){
+		*dataL = (Uint32)(payload >> 32);
+		*dataH = (Uint32)payload;
+	}
+	else{
+		*dataL = swapBytes((Uint32)payload);
+		*dataH = swapBytes((Uint32)(payload >> 32));
+	}
+}
+
+// @brief A signal in engineering units: raw*scale + offset, or the float itself for CAN_SIG_FLOAT.
+float32 unpackSignal(Uint32 dataL, Uint32 dataH, const CAN_SIGNAL* sig){
+	Uint32 raw = unpackBits(dataL, dataH, sig);
+
+	switch(sig->type){
+	case CAN_SIG_FLOAT:
+		return convertInt(raw);
+	case CAN_SIG_SIGNED:
+		if(sig->length < 32 && (raw >> (sig->length - 1)))
+			raw |= ~(Uint32)0 << sig->length; // Sign-extend
+		return (int32)raw * sig->scale + sig->offset;
+	default:
+		return raw * sig->scale + sig->offset;
+	}
+}
+
+/*
+ * @brief Store a value in engineering units, rounded to the nearest step and clamped to what fits.
+ * The limits are compared as powers of two, which a float32 holds exactly whatever the length,
+ * and the clamped value is worked out in integers: 2^n - 1 itself is not a float32 once n >= 24.
+ */
+void packSignal(Uint32* dataL, Uint32* dataH, const CAN_SIGNAL* sig, float32 value){
+	float32 steps, limit;
+	Uint32 raw;
+
+	if(sig->type == CAN_SIG_FLOAT){
+		packBits(dataL, dataH, sig, convertFloat(value));
+		return;
+	}
+	steps = (value - sig->offset) / sig->scale;
+	steps += (steps < 0) ? -0.5 : 0.5; // The casts below truncate, so this rounds
+	if(sig->type == CAN_SIG_SIGNED){
+		limit = (float32)((Uint32)1 << (sig->length - 1)); // 2^(n-1)
+		if(steps >= limit)
+			raw = ((Uint32)1 << (sig->length - 1)) - 1;
+		else if(steps <= -limit)
+			raw = (Uint32)0 - ((Uint32)1 << (sig->length - 1));
+		else
+			raw = (Uint32)(int32)steps;
+	}
+	else{
+		limit = (sig->length < 32) ? (float32)((Uint32)1 << sig->length) : 4294967296.0; // 2^n
+		if(steps >= limit)
+			raw = (sig->length < 32) ? ((Uint32)1 << sig->length) - 1 : 0xFFFFFFFF;
+		else if(steps < 0)
+			raw = 0;
+		else
+			raw = (Uint32)steps;
+	}
+	packBits(dataL, dataH, sig, raw);
+}
@@ -1,21 +1,42 @@
-/*
- * CAN_formatting.h
- *
- *  Created on: Oct 25, 2014
- *      Author: Andrey
- */
-#include "F2806x_Cla_typedefs.h"// F2806x CLA Type definitions
-
-#ifndef CAN_FORMATTING_H_
-#define CAN_FORMATTING_H_
-
-Uint32 convertFloat(float32 f);
-float32 convertInt(Uint32 i);
-Uint32* convertFloats(float32* floats, int length);
-float32* convertInts(Uint32* ints, int length);
-Uint32 combineChars(char last, char third, char second, char first);
-Uint32 combineIntHalves(Uint16 dataH, Uint16 dataL);
-Uint16 getFirstHalf(Uint32 v);
-Uint16 getSecondHalf(Uint32 v);
-Uint32* putIntoBuffer(Uint32 DataH, Uint32 DataL);
-#endif /* CAN_FORMATTING_H_ */
+/*
+ * CAN_formatting.h
+ *
+ *  Created on: Oct 25, 2014
+ *      Author: Andrey
+ */
+#include "F2806x_Cla_typedefs.h"// F2806x CLA Type definitions
+
+#ifndef CAN_FORMATTING_H_
+#define CAN_FORMATTING_H_
+
+typedef enum{
+	CAN_SIG_UNSIGNED,
+	CAN_SIG_SIGNED,
+	CAN_SIG_FLOAT		// IEEE single, length 32
+}CAN_SIG_TYPE;
+
+// Where a value lives in a frame's 8 data bytes, and how to scale it (see CAN_formatting.c).
+typedef struct{
+	Uint16 start;		// DBC start bit
+	Uint16 length;		// Bits, 1-32
+	Uint16 motorola;	// 1 = big-endian, 0 = Intel
+	CAN_SIG_TYPE type;
+	float32 scale;		// Engineering units per count (ignored for floats)
+	float32 offset;
+}CAN_SIGNAL;
+
+Uint32 convertFloat(float32 f);
+float32 convertInt(Uint32 i);
+Uint32* convertFloats(float32* floats, Uint32* ints, int length);
+float32* convertInts(Uint32* ints, float32* floats, int length);
+Uint32 combineChars(char last, char third, char second, char first);
+Uint32 combineIntHalves(Uint16 dataH, Uint16 dataL);
+Uint16 getFirstHalf(Uint32 v);
+Uint16 getSecondHalf(Uint32 v);
+Uint32* putIntoBuffer(Uint32 DataH, Uint32 DataL, Uint32* buffer);
+
+Uint32 unpackBits(Uint32 dataL, Uint32 dataH, const CAN_SIGNAL* sig);
+void packBits(Uint32* dataL, Uint32* dataH, const CAN_SIGNAL* sig, Uint32 raw);
+float32 unpackSignal(Uint32 dataL, Uint32 dataH, const CAN_SIGNAL* sig);
+void packSignal(Uint32* dataL, Uint32* dataH, const CAN_SIGNAL* sig, float32 value);
+#endif /* CAN_FORMATTING_H_ */
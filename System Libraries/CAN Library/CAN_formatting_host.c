@@ -0,0 +1,123 @@
+/*
+ * CAN_formatting_host.c
+ *
+ * Not part of the target build. Round-trips signals through packSignal/unpackSignal on a PC and
+ * times them, e.g.
+ *
+ * gcc -O2 -I28069Common/h "System Libraries/CAN Library/CAN_formatting_host.c" -o canfmt && ./canfmt
+ *
+ * The types are pinned to the C28x's widths before CAN_formatting.c is pulled in, so a PC's 64-bit
+ * long doesn't change what is being tested. The times are the PC's, not the F28069's: use them to
+ * compare changes to the codec, not to budget the ISR.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#define DSP28_DATA_TYPES
+typedef int16_t int16;
+typedef int32_t int32;
+typedef uint16_t Uint16;
+typedef uint32_t Uint32;
+typedef float float32;
+#include "CAN_formatting.c"
+
+#define LOOPS 2000000
+
+static const CAN_SIGNAL SIGNALS[] = {
+	{0, 16, 0, CAN_SIG_UNSIGNED, 0.01, 0},		// Intel, byte aligned
+	{7, 16, 1, CAN_SIG_UNSIGNED, 0.01, 0},		// Motorola, byte aligned
+	{20, 12, 0, CAN_SIG_SIGNED, 0.1, -5},		// Intel, across bytes
+	{13, 3, 1, CAN_SIG_UNSIGNED, 1, 0},			// Motorola, inside a byte
+	{32, 32, 0, CAN_SIG_FLOAT, 1, 0},			// IEEE single
+	{8, 24, 0, CAN_SIG_UNSIGNED, 1, 0},			// Wider than a float32's mantissa
+	{0, 32, 0, CAN_SIG_SIGNED, 1, 0},
+	{0, 32, 0, CAN_SIG_UNSIGNED, 1, 0},
+};
+#define NSIGNALS (sizeof(SIGNALS)/sizeof(SIGNALS[0]))
+
+static int failures = 0;
+
+// @brief Pack value into an otherwise all-ones payload, check it unpacks as expected and that
+// nothing else moved.
+static void check(const CAN_SIGNAL* sig, float32 value, float32 expect){
+	Uint32 dataL = 0xFFFFFFFF, dataH = 0xFFFFFFFF;
+	Uint32 otherL, otherH;
+	float32 got, tolerance = (sig->type == CAN_SIG_FLOAT) ? 0 : sig->scale / 2;
+
+	tolerance += (expect < 0 ? -expect : expect) * 1e-6; // A float32's own rounding
+
+	packSignal(&dataL, &dataH, sig, value);
+	got = unpackSignal(dataL, dataH, sig);
+	if (got - expect > tolerance || expect - got > tolerance){
+		printf("FAIL start %u length %u: packed %.9g, got %.9g, expected %.9g\n",
+				sig->start, sig->length, value, got, expect);
+		failures++;
+	}
+	otherL = dataL;
+	otherH = dataH;
+	packBits(&otherL, &otherH, sig, 0xFFFFFFFF);
+	if (otherL != 0xFFFFFFFF || otherH != 0xFFFFFFFF){
+		printf("FAIL start %u length %u: bits outside the signal changed\n", sig->start, sig->length);
+		failures++;
+	}
+}
+
+// @brief Largest and smallest values the signal can hold, in engineering units.
+static void limits(const CAN_SIGNAL* sig, double* lo, double* hi){
+	double span = (double)((Uint64)1 << sig->length);
+
+	if (sig->type == CAN_SIG_SIGNED){
+		*lo = -span/2 * sig->scale + sig->offset;
+		*hi = (span/2 - 1) * sig->scale + sig->offset;
+	}
+	else{
+		*lo = sig->offset;
+		*hi = (span - 1) * sig->scale + sig->offset;
+	}
+}
+
+int main(void){
+	Uint16 i, n;
+	Uint32 dataL, dataH;
+	double lo, hi, seconds;
+	volatile float32 sink = 0;
+	clock_t start;
+
+	for (i=0; i<NSIGNALS; i++){
+		const CAN_SIGNAL* sig = &SIGNALS[i];
+		if (sig->type == CAN_SIG_FLOAT){
+			check(sig, 3.25, 3.25);
+			check(sig, -1e30, -1e30);
+			continue;
+		}
+		limits(sig, &lo, &hi);
+		check(sig, lo, lo);
+		check(sig, hi, hi);
+		check(sig, (lo + hi)/2, (lo + hi)/2);
+		check(sig, hi*4 + 1000, hi);	// Saturates high
+		check(sig, lo*4 - 1000, lo);	// and low
+	}
+
+	for (i=0; i<NSIGNALS; i++){
+		const CAN_SIGNAL* sig = &SIGNALS[i];
+		limits(sig, &lo, &hi);
+		dataL = dataH = 0;
+		start = clock();
+		for (n=0; n<LOOPS/1000; n++){
+			Uint16 k;
+			for (k=0; k<1000; k++){
+				packSignal(&dataL, &dataH, sig, lo + (hi - lo) * (k & 63) / 64);
+				sink += unpackSignal(dataL, dataH, sig);
+			}
+		}
+		seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+		printf("start %2u length %2u %s %-8s %6.1f ns per pack+unpack\n", sig->start, sig->length,
+				sig->motorola ? "Motorola" : "Intel   ",
+				sig->type == CAN_SIG_FLOAT ? "float" : sig->type == CAN_SIG_SIGNED ? "signed" : "unsigned",
+				seconds * 1e9 / LOOPS);
+	}
+
+	printf(failures ? "%d FAILED\n" : "ok\n", failures);
+	return failures != 0;
+}
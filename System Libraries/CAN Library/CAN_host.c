@@ -0,0 +1,201 @@
+/*
+ * CAN_host.c
+ *
+ * Not part of the target build. Runs CAN.c's transmit queue on a PC against a stand-in for the
+ * eCAN's transmit arbitration (highest TPL first, then the highest-numbered mailbox) and checks
+ * that frames leave in queue order: by bus priority, then first come first served. From the top
+ * of the tree:
+ *
+ * gcc -O2 -w -D__cregister= -Dinterrupt= -D__interrupt= -Dcregister= -D'asm(x)=' -D'__asm(x)='
+ * 	-D"__disable_interrupts()=0" -D"__restore_interrupts(x)=(void)(x)" -I28069Common/h
+ * 	-I"System Libraries/CAN Library" "System Libraries/CAN Library/CAN_host.c" -o cantx && ./cantx
+ *
+ * The registers are plain memory here, so the write-1 registers (CANTRS, CANTA) are emulated
+ * around each call into CAN.c.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define DSP28_DATA_TYPES // C28x widths, so the 32-bit registers stay 32 bits
+#define _TI_STD_TYPES
+typedef int16_t int16;
+typedef int32_t int32;
+typedef long long int64;
+typedef unsigned long long Uint64; // as F2806x_Cla_typedefs.h has it
+typedef float float32;
+typedef double float64;
+typedef uint32_t Uint32;
+typedef uint16_t Uint16;
+typedef uint8_t Uint8;
+#include "CAN.c"
+
+volatile struct ECAN_REGS ECanaRegs;
+volatile struct ECAN_MBOXES ECanaMboxes;
+volatile struct LAM_REGS ECanaLAMRegs;
+volatile struct PIE_CTRL_REGS PieCtrlRegs;
+struct PIE_VECT_TABLE PieVectTable;
+volatile struct SYS_CTRL_REGS SysCtrlRegs;
+volatile unsigned int IER, IFR;
+
+// CAN.c refers to these, but nothing here calls them
+void InitECanGpio(void){}
+void InitECana(void){}
+
+#define POOL 0xE0000000 // Three mailboxes, so frames have to wait for one
+#define RUNS 2000
+
+static Uint32 trs; // Mailboxes asked to transmit and not yet sent
+static int failures = 0;
+
+// @brief Pick up what CAN.c asked for: writing 1 to CANTRS sets the bit on the chip.
+static void latch(void){
+	trs |= ECanaRegs.CANTRS.all;
+	ECanaRegs.CANTRS.all = 0;
+}
+
+// @brief Put the eCAN's choice of mailbox on the bus and hand back its TA. Returns the frame's ID and
+// its data in *data, or -1 if nothing is waiting.
+static long transmit(Uint32* data){
+	volatile struct MBOX* Mailbox;
+	int best = -1, tpl = -1, i;
+	long ID;
+
+	for (i=CAN_MBOXES-1; i>=0; i--){
+		if ((trs & ((Uint32)1 << i)) && (int)(&ECanaMboxes.MBOX0 + i)->MSGCTRL.bit.TPL > tpl){
+			best = i;
+			tpl = (&ECanaMboxes.MBOX0 + i)->MSGCTRL.bit.TPL;
+		}
+	}
+	if (best < 0){
+		return -1;
+	}
+	Mailbox = &ECanaMboxes.MBOX0 + best;
+	*data = Mailbox->MDL.all;
+	ID = (long)CAN_decode_id(Mailbox->MSGID.all); // Before the refill overwrites it
+	trs &= ~((Uint32)1 << best);
+	ECanaRegs.CANTA.all = (Uint32)1 << best;
+	CAN_tx_poll();
+	ECanaRegs.CANTA.all = 0; // Its write of 1 cleared it
+	latch();
+	return ID;
+}
+
+static void queue(CAN_ID ID, Uint32 data){
+	CAN_FRAME frame;
+
+	frame.ID = ID;
+	frame.length = 4;
+	frame.dataL = data;
+	frame.dataH = 0;
+	if (!CAN_queue(&frame)){
+		printf("FAIL: queue full\n");
+		failures++;
+	}
+	latch();
+}
+
+static void reset(void){
+	memset((void*)&ECanaRegs, 0, sizeof(ECanaRegs));
+	memset((void*)&ECanaMboxes, 0, sizeof(ECanaMboxes));
+	CAN_TX_COUNT = 0;
+	CAN_tx_pool(POOL);
+	trs = 0;
+}
+
+// @brief Send everything queued and check it went in the order given
+static void expect(const char* what, const long* ids, const Uint32* data, int n){
+	Uint32 d;
+	long id;
+	int i;
+
+	for (i=0; i<n; i++){
+		id = transmit(&d);
+		if (id != ids[i] || d != data[i]){
+			printf("FAIL %s: frame %d was ID %ld data %lu, expected ID %ld data %lu\n", what, i, id,
+					(unsigned long)d, ids[i], (unsigned long)data[i]);
+			failures++;
+			return;
+		}
+	}
+	if (transmit(&d) != -1){
+		printf("FAIL %s: more frames than were queued\n", what);
+		failures++;
+	}
+}
+
+int main(void){
+	static const long order[5] = {1, 2, 3, 4, 5};
+	static const Uint32 order_data[5] = {10, 20, 30, 40, 50};
+	static const long late[4] = {3, 1, 4, 5};
+	static const Uint32 late_data[4] = {30, 10, 40, 50};
+	static const long same[5] = {2, 2, 2, 2, 2};
+	static const Uint32 same_data[5] = {0, 1, 2, 3, 4};
+	Uint32 d, last_data[8];
+	long id;
+	int i, run, sent, queued;
+
+	// Five frames through three mailboxes: the two loaded on refills rank below those still waiting
+	reset();
+	for (i=0; i<5; i++){
+		queue((CAN_ID)order[i], order_data[i]);
+	}
+	expect("refill", order, order_data, 5);
+
+	// A more urgent frame queued behind a full pool goes next, ahead of the ones loaded before it
+	reset();
+	queue((CAN_ID)3, 30);
+	queue((CAN_ID)4, 40);
+	queue((CAN_ID)5, 50);
+	queue((CAN_ID)1, 10);
+	expect("late urgent frame", late, late_data, 4);
+
+	// Frames with one ID stay in the order they were queued
+	reset();
+	for (i=0; i<5; i++){
+		queue((CAN_ID)2, i);
+	}
+	expect("same ID", same, same_data, 5);
+
+	// Random queueing and sending: each frame that goes must be the first, in queue order, of those
+	// loaded, and each ID's frames must go in the order they were queued
+	srand(1);
+	for (run=0; run<RUNS; run++){
+		reset();
+		for (i=0; i<8; i++){
+			last_data[i] = 0;
+		}
+		sent = queued = 0;
+		while (sent < 40){
+			if (queued < 40 && CAN_TX_COUNT < CAN_TX_QUEUE_SIZE && rand() % 2){
+				id = rand() % 8;
+				queue((CAN_ID)id, ++queued);
+				continue;
+			}
+			Uint32 best_id = 0xFFFFFFFF, best_seq = 0, b;
+			for (i=0; i<CAN_MBOXES; i++){
+				b = (Uint32)1 << i;
+				if ((trs & b) && (best_id == 0xFFFFFFFF || CAN_tx_ahead(CAN_TX_INFLIGHT[i],
+						CAN_TX_INFLIGHT_SEQ[i], (CAN_ID)best_id, best_seq))){
+					best_id = CAN_TX_INFLIGHT[i];
+					best_seq = CAN_TX_INFLIGHT_SEQ[i];
+				}
+			}
+			id = transmit(&d);
+			if (id == -1){
+				continue;
+			}
+			sent++;
+			if (id != (long)best_id || d <= last_data[id]){
+				printf("FAIL random run %d: ID %ld (data %lu) went, expected ID %lu\n", run, id,
+						(unsigned long)d, (unsigned long)best_id);
+				failures++;
+				break;
+			}
+			last_data[id] = d;
+		}
+	}
+
+	printf(failures ? "%d FAILED\n" : "ok\n", failures);
+	return failures != 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * CAN_log.c
+ *
+ * Every frame received into the chosen mailboxes is copied, with the time-stamp counter value the
+ * eCAN latched into its MOTS register as it arrived, into a ring that ecan_isr fills and the main
+ * loop empties. Only ecan_isr writes head and only the main loop writes tail, so neither side needs
+ * to turn interrupts off. When the ring is full new frames are dropped and counted.
+ *
+ * The time-stamp counter runs at the bit rate (1 tick = 2us at 500kbps) and is the same clock for
+ * every mailbox, so a node that hears both the pedals and the motor controller can time one against
+ * the other to within a bit. Needs the eCAN in eCAN mode (SCB = 1, as InitECana leaves it).
+ *
+ * Example: log everything to SCI A, to be read with canlog.py
+ *
+ * void to_sci(char* bytes, Uint16 length){
+ * 	sendCharArray(SCIA, bytes, length);
+ * }
+ * ...
+ * CAN_init(...);
+ * CAN_receive(PEDALS, 8, 0, 0);
+ * CAN_receive(MOTOR_CONTROLLER, 8, 1, 0);
+ * SetSciBaudRate(SciInit(Ain28, Aout29), getfclk(), 115.2);
+ * CAN_log_init(0x00000003); // Mailboxes 0 and 1
+ * while(1){
+ * 	CAN_log_drain(&to_sci, 4);
+ * 	...
+ * }
+ *
+ * Each record is CAN_LOG_RECORD bytes:
+ *   0      CAN_LOG_MARK
+ *   1      seq, low byte: gaps are frames dropped
+ *   2      length (DLC)
+ *   3      mailbox
+ *   4-7    stamp, little-endian
+ *   8-11   ID, little-endian
+ *   12-19  data, in the order it was on the bus
+ *   20     checksum: the low byte of the sum of bytes 0-19
+ */
+#include "DSP28x_Project.h"
+#include "CAN_log.h"
+
+volatile CAN_LOG_ENTRY CAN_LOG_RING[CAN_LOG_SIZE];
+volatile Uint16 CAN_LOG_HEAD;	// Next slot ecan_isr fills
+volatile Uint16 CAN_LOG_TAIL;	// Next slot the main loop reads
+Uint32 CAN_LOG_MASK;			// Mailboxes logged
+Uint16 CAN_LOG_SEQ;
+Uint32 CAN_LOG_DROPPED;
+void (*CAN_LOG_NEXT_HOOK)(Uint16 mbox_num); // Whatever had CAN_rx_hook before CAN_log_init
+
+// @brief Copy the frame in a logged mailbox into the ring
+static void CAN_log_store(Uint16 mbox_num){
+	volatile struct MBOX* Mailbox;
+	volatile CAN_LOG_ENTRY* entry;
+	Uint16 head = CAN_LOG_HEAD;
+
+	CAN_LOG_SEQ++;
+	if (((head + 1) & (CAN_LOG_SIZE - 1)) == CAN_LOG_TAIL){
+		CAN_LOG_DROPPED++;
+		return;
+	}
+
+	Mailbox = &ECanaMboxes.MBOX0 + mbox_num;
+	entry = &CAN_LOG_RING[head];
+	entry->stamp = (&ECanaMOTSRegs.MOTS0)[mbox_num];
+	entry->ID = CAN_decode_id(Mailbox->MSGID.all);
+	entry->length = Mailbox->MSGCTRL.bit.DLC;
+	entry->mbox_num = mbox_num;
+	entry->seq = CAN_LOG_SEQ;
+	entry->dataL = Mailbox->MDL.all;
+	entry->dataH = Mailbox->MDH.all;
+	CAN_LOG_HEAD = (head + 1) & (CAN_LOG_SIZE - 1); // Only now can the main loop see it
+}
+
+// @brief CAN_rx_hook: runs in ecan_isr, before the frame is handed on.
+static void CAN_log_capture(Uint16 mbox_num){
+	if (CAN_LOG_MASK & ((Uint32)1 << mbox_num)){
+		CAN_log_store(mbox_num);
+	}
+	if (CAN_LOG_NEXT_HOOK){
+		CAN_LOG_NEXT_HOOK(mbox_num);
+	}
+}
+
+/*
+ * @brief Start logging frames received into the mailboxes in mbox_mask. Call after CAN_init, and
+ * with CAN interrupts enabled: frames are only caught in ecan_isr. Takes over CAN_rx_hook, passing
+ * every frame on to whatever hook was there before.
+ */
+void CAN_log_init(Uint32 mbox_mask){
+	CAN_LOG_HEAD = 0;
+	CAN_LOG_TAIL = 0;
+	CAN_LOG_SEQ = 0;
+	CAN_LOG_DROPPED = 0;
+	CAN_LOG_MASK = mbox_mask;
+	if (CAN_rx_hook != &CAN_log_capture){ // Not when called again: it would call itself
+		CAN_LOG_NEXT_HOOK = CAN_rx_hook;
+	}
+	CAN_rx_hook = &CAN_log_capture;
+}
+
+/*
+ * @brief Stop logging. The hook CAN_log_init replaced gets CAN_rx_hook back, unless another has been
+ * put in front of the log since, which then keeps passing frames through it.
+ */
+void CAN_log_stop(void){
+	CAN_LOG_MASK = 0;
+	if (CAN_rx_hook == &CAN_log_capture){
+		CAN_rx_hook = CAN_LOG_NEXT_HOOK;
+		CAN_LOG_NEXT_HOOK = 0;
+	}
+}
+
+/*
+ * @brief Take the oldest frame out of the log.
+ * @return 1, or 0 if the log was empty
+ */
+Uint16 CAN_log_read(CAN_LOG_ENTRY* entry){
+	volatile CAN_LOG_ENTRY* slot;
+	Uint16 tail = CAN_LOG_TAIL;
+
+	if (tail == CAN_LOG_HEAD){
+		return 0;
+	}
+	slot = &CAN_LOG_RING[tail];
+	entry->stamp = slot->stamp;
+	entry->ID = slot->ID;
+	entry->length = slot->length;
+	entry->mbox_num = slot->mbox_num;
+	entry->seq = slot->seq;
+	entry->dataL = slot->dataL;
+	entry->dataH = slot->dataH;
+	CAN_LOG_TAIL = (tail + 1) & (CAN_LOG_SIZE - 1); // Only now can ecan_isr reuse it
+	return 1;
+}
+
+static void CAN_log_put32(char* bytes, Uint32 value){
+	bytes[0] = value & 0xFF;
+	bytes[1] = (value >> 8) & 0xFF;
+	bytes[2] = (value >> 16) & 0xFF;
+	bytes[3] = (value >> 24) & 0xFF;
+}
+
+/*
+ * @brief Write up to max logged frames to write, one record (see above) per call. Call from the
+ * main loop; keep max small if write blocks, as sendCharArray does.
+ * @return How many were written
+ */
+Uint16 CAN_log_drain(void (*write)(char* bytes, Uint16 length), Uint16 max){
+	CAN_LOG_ENTRY entry;
+	char record[CAN_LOG_RECORD];
+	Uint16 i, n, sum;
+
+	for (n=0; n<max && CAN_log_read(&entry); n++){
+		record[0] = CAN_LOG_MARK;
+		record[1] = entry.seq & 0xFF;
+		record[2] = entry.length;
+		record[3] = entry.mbox_num;
+		CAN_log_put32(&record[4], entry.stamp);
+		CAN_log_put32(&record[8], entry.ID);
+		for (i=0; i<4; i++){ // With DBO = 0 the first byte on the bus is the top of MDL
+			record[12 + i] = (entry.dataL >> (24 - 8*i)) & 0xFF;
+			record[16 + i] = (entry.dataH >> (24 - 8*i)) & 0xFF;
+		}
+		sum = 0;
+		for (i=0; i<CAN_LOG_RECORD - 1; i++){
+			sum += record[i] & 0xFF;
+		}
+		record[CAN_LOG_RECORD - 1] = sum & 0xFF;
+		write(record, CAN_LOG_RECORD);
+	}
+	return n;
+}
+
+// @brief Frames waiting to be read
+Uint16 CAN_log_count(void){
+	return (CAN_LOG_HEAD - CAN_LOG_TAIL) & (CAN_LOG_SIZE - 1);
+}
+
+// @brief Frames lost because the log was full
+Uint32 CAN_log_dropped(void){
+	return CAN_LOG_DROPPED;
+}
@@ -0,0 +1,33 @@
+/*
+ * CAN_log.h
+ *
+ * Received frames with their hardware timestamps, kept in a ring for the main loop to write out.
+ */
+#include "F2806x_Cla_typedefs.h"
+#include "CAN.h"
+
+#ifndef CAN_LOG_H_
+#define CAN_LOG_H_
+
+#define CAN_LOG_SIZE 64 // Frames the ring holds. A power of 2
+#define CAN_LOG_RECORD 21 // Bytes per frame written by CAN_log_drain
+#define CAN_LOG_MARK 0xC4 // First byte of every record
+
+typedef struct{
+	Uint32 stamp;	// CANTSC when the frame arrived, in bit times
+	Uint32 ID;		// With CAN_EXT if extended
+	Uint16 length;
+	Uint16 mbox_num;
+	Uint16 seq;		// Counts every frame seen, logged or dropped
+	Uint32 dataL;
+	Uint32 dataH;
+}CAN_LOG_ENTRY;
+
+void CAN_log_init(Uint32 mbox_mask);
+void CAN_log_stop(void);
+Uint16 CAN_log_read(CAN_LOG_ENTRY* entry);
+Uint16 CAN_log_drain(void (*write)(char* bytes, Uint16 length), Uint16 max);
+Uint16 CAN_log_count(void);
+Uint32 CAN_log_dropped(void);
+
+#endif /* CAN_LOG_H_ */
@@ -0,0 +1,287 @@
+/*
+ * CAN_schedule.c
+ *
+ * Instead of "if (tmrcnt % 100 == 0) CAN_send(...)" scattered through timerISR, list the periodic
+ * messages once and call CAN_sched_tick from the timer:
+ *
+ * Uint16 send_bms(CAN_FRAME* frame){
+ * 	BMS_MSG m;
+ * 	...
+ * 	BMS_pack(&m, &frame->dataL, &frame->dataH);
+ * 	frame->length = BMS_DLC;
+ * 	return 1;
+ * }
+ *
+ * CAN_SCHED_ENTRY schedule[] = {
+ * 	{BMS, 100, CAN_SCHED_AUTO, &send_bms}, // Every 100 ticks
+ * 	{MPPT, 250, CAN_SCHED_AUTO, &send_mppt},
+ * };
+ *
+ * CAN_init(...);
+ * SysClkInit(EIGHTY);
+ * TimerInit(1); // 1kHz: ticks are ms
+ * CAN_sched_init(schedule, 2); // Before the timer interrupt is enabled
+ * IsrInit(TINT0, &timerISR);
+ *
+ * interrupt void timerISR(void){
+ * 	CAN_sched_tick();
+ * 	IsrAck(TINT0);
+ * }
+ *
+ * Messages with CAN_SCHED_AUTO offsets are spread out so as few as possible fall due on the same
+ * tick. Producers run inside the timer interrupt, so keep them short.
+ *
+ * Each message's latency, from being queued to its TA, is measured in CPU timer 0 cycles (SYSCLK;
+ * divide by getfclk() for us). Its spread, latency_max - latency_min, is the jitter the bus and
+ * the queue add on top of the tick. A message still in flight when its next one falls due is
+ * counted as missed and that instance is skipped rather than piled up behind it.
+ */
+#include "DSP28x_Project.h"
+#include "CAN_schedule.h"
+
+CAN_SCHED_ENTRY* CAN_SCHED_TABLE;
+volatile Uint16 CAN_SCHED_LENGTH; // Published last by CAN_sched_init
+Uint32 CAN_SCHED_TICK; // The tick being (or last) handled
+void (*CAN_SCHED_NEXT_HOOK)(CAN_ID ID); // Whatever had CAN_tx_hook before CAN_sched_init
+
+static void CAN_sched_sent(CAN_ID ID);
+
+static Uint32 CAN_sched_gcd(Uint32 a, Uint32 b){
+	Uint32 t;
+
+	while (b){
+		t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+// @brief How many of the already-placed messages fall due on tick t
+static Uint16 CAN_sched_load_at(CAN_SCHED_ENTRY* table, Uint16 length, Uint32 t){
+	CAN_SCHED_ENTRY* e;
+	Uint16 i, n = 0;
+
+	for (i=0; i<length; i++){
+		e = &table[i];
+		if (e->offset != CAN_SCHED_AUTO && t >= e->offset && (t - e->offset) % e->period == 0){
+			n++;
+		}
+	}
+	return n;
+}
+
+/*
+ * @brief Pick offsets for the CAN_SCHED_AUTO entries, shortest period first. Each gets the offset
+ * whose worst tick (over the hyperperiod, or CAN_SCHED_HORIZON ticks if that is longer) is least
+ * crowded by the messages already placed, then the least crowded overall.
+ */
+static void CAN_sched_stagger(CAN_SCHED_ENTRY* table, Uint16 length){
+	CAN_SCHED_ENTRY* e;
+	Uint32 horizon = 1;
+	Uint32 t, worst, total, best_worst, best_total;
+	Uint16 i, o, best, load;
+
+	for (i=0; i<length; i++){
+		horizon = horizon / CAN_sched_gcd(horizon, table[i].period) * table[i].period;
+		if (horizon > CAN_SCHED_HORIZON){
+			horizon = CAN_SCHED_HORIZON;
+			break;
+		}
+	}
+
+	while (1){
+		e = 0;
+		for (i=0; i<length; i++){
+			if (table[i].offset == CAN_SCHED_AUTO && (!e || table[i].period < e->period)){
+				e = &table[i];
+			}
+		}
+		if (!e){
+			return;
+		}
+
+		best = 0;
+		best_worst = best_total = 0xFFFFFFFF;
+		for (o=0; o<e->period; o++){
+			worst = total = 0;
+			for (t=o; t<horizon || t==o; t+=e->period){
+				load = CAN_sched_load_at(table, length, t);
+				total += load;
+				if (load > worst){
+					worst = load;
+				}
+			}
+			if (worst < best_worst || (worst == best_worst && total < best_total)){
+				best = o;
+				best_worst = worst;
+				best_total = total;
+			}
+		}
+		e->offset = best;
+	}
+}
+
+static void CAN_sched_clear_stats(CAN_SCHED_ENTRY* table, Uint16 length){
+	CAN_SCHED_ENTRY* e;
+	Uint16 i;
+
+	for (i=0; i<length; i++){
+		e = &table[i];
+		e->sent = 0;
+		e->missed = 0;
+		e->latency_min = 0xFFFFFFFF;
+		e->latency_max = 0;
+		e->latency_sum = 0;
+	}
+}
+
+/*
+ * @brief Start sending the messages in table, on the next CAN_sched_tick. Call after CAN_init and
+ * TimerInit, and before the timer interrupt is enabled: staggering the offsets takes a while. Even
+ * so, CAN_sched_tick sees an empty table until everything is set up. Takes over CAN_tx_hook, passing
+ * every frame on to whatever hook was there before. The IDs in the table shouldn't also be sent some
+ * other way, or their latencies will be muddled.
+ */
+void CAN_sched_init(CAN_SCHED_ENTRY* table, Uint16 length){
+	Uint16 i;
+
+	CAN_SCHED_LENGTH = 0; // Until the table is ready, ticks do nothing
+
+	for (i=0; i<length; i++){
+		if (table[i].period == 0){
+			table[i].period = 1;
+		}
+		if (table[i].offset != CAN_SCHED_AUTO && table[i].offset >= table[i].period){
+			table[i].offset %= table[i].period;
+		}
+	}
+	CAN_sched_stagger(table, length);
+	for (i=0; i<length; i++){
+		table[i].next = table[i].offset;
+		table[i].pending = 0;
+		table[i].length = 8;
+	}
+	CAN_sched_clear_stats(table, length);
+	if (CAN_tx_hook != &CAN_sched_sent){ // Not when called again: it would call itself
+		CAN_SCHED_NEXT_HOOK = CAN_tx_hook;
+	}
+	CAN_tx_hook = &CAN_sched_sent;
+
+	CAN_SCHED_TABLE = table;
+	CAN_SCHED_TICK = 0xFFFFFFFF; // The first tick is 0
+	CAN_SCHED_LENGTH = length; // Last: only now can CAN_sched_tick see the table
+}
+
+void CAN_sched_reset_stats(void){
+	CAN_sched_clear_stats(CAN_SCHED_TABLE, CAN_SCHED_LENGTH);
+}
+
+/*
+ * @brief CPU timer 0 cycles since CAN_sched_init, good to a cycle. Wraps every 2^32 cycles. Between
+ * the timer wrapping and its interrupt being taken (in ecan_isr, say), CAN_SCHED_TICK is a tick
+ * behind; TINT0 is then pending in the PIE, so count that tick too (which assumes CAN_sched_tick
+ * runs from TINT0's interrupt, as in the example). The flag is read either side of TIM so that a
+ * wrap in between doesn't pair a new count with an old flag.
+ */
+Uint32 CAN_sched_now(void){
+	Uint32 prd = CpuTimer0Regs.PRD.all;
+	Uint32 tim;
+	Uint16 pending;
+
+	do{
+		pending = PieCtrlRegs.PIEIFR1.bit.INTx7; // TINT0
+		tim = CpuTimer0Regs.TIM.all;
+	}while (pending != PieCtrlRegs.PIEIFR1.bit.INTx7);
+	return (CAN_SCHED_TICK + pending) * (prd + 1) + (prd - tim);
+}
+
+// @brief Call once per timer interrupt.
+void CAN_sched_tick(void){
+	CAN_SCHED_ENTRY* e;
+	CAN_FRAME frame;
+	Uint16 i;
+
+	CAN_SCHED_TICK++;
+	for (i=0; i<CAN_SCHED_LENGTH; i++){
+		e = &CAN_SCHED_TABLE[i];
+		if (CAN_SCHED_TICK != e->next){
+			continue;
+		}
+		e->next += e->period;
+		if (e->pending){
+			e->missed++; // The last one still hasn't gone
+			continue;
+		}
+
+		frame.ID = e->ID;
+		frame.length = 8;
+		frame.dataL = 0;
+		frame.dataH = 0;
+		if (!e->producer || !e->producer(&frame)){
+			continue;
+		}
+		e->length = frame.length;
+		e->due = CAN_sched_now();
+		if (CAN_queue(&frame)){
+			e->pending = 1;
+		}
+		else{
+			e->missed++;
+		}
+	}
+}
+
+// @brief CAN_tx_hook: a queued frame has gone out. Passed on to the hook CAN_sched_init replaced.
+static void CAN_sched_sent(CAN_ID ID){
+	CAN_SCHED_ENTRY* e;
+	Uint32 latency;
+	Uint16 i;
+
+	for (i=0; i<CAN_SCHED_LENGTH; i++){
+		e = &CAN_SCHED_TABLE[i];
+		if (e->pending && e->ID == ID){
+			latency = CAN_sched_now() - e->due;
+			if ((int32)latency < 0){
+				latency = 0; // Can't go before it was queued; don't let it wrap into latency_max
+			}
+			e->pending = 0;
+			e->sent++;
+			e->latency_sum += latency;
+			if (latency < e->latency_min){
+				e->latency_min = latency;
+			}
+			if (latency > e->latency_max){
+				e->latency_max = latency;
+			}
+			break;
+		}
+	}
+	if (CAN_SCHED_NEXT_HOOK){
+		CAN_SCHED_NEXT_HOOK(ID);
+	}
+}
+
+/*
+ * @brief The fraction of the bus the schedule takes, counting each frame at its worst-case stuffed
+ * length plus the 3-bit interframe space: 8n + 47 + (34 + 8n - 1)/4 bits for n data bytes with an
+ * 11-bit ID, and 8n + 67 + (54 + 8n - 1)/4 with a 29-bit one.
+ * tick_ms is the tick period (1 for TimerInit(1)); baud_kbps the bus rate, e.g. 500.
+ */
+float32 CAN_sched_load(float32 tick_ms, float32 baud_kbps){
+	CAN_SCHED_ENTRY* e;
+	float32 bits_per_ms = 0;
+	Uint16 i, bits;
+
+	for (i=0; i<CAN_SCHED_LENGTH; i++){
+		e = &CAN_SCHED_TABLE[i];
+		if (CAN_IS_EXT(e->ID)){
+			bits = 8*e->length + 67 + (54 + 8*e->length - 1)/4;
+		}
+		else{
+			bits = 8*e->length + 47 + (34 + 8*e->length - 1)/4;
+		}
+		bits_per_ms += bits / (e->period * tick_ms);
+	}
+	return bits_per_ms / baud_kbps; // kbit/s is bits per ms
+}
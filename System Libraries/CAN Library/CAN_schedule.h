@@ -0,0 +1,39 @@
+/*
+ * CAN_schedule.h
+ *
+ * Periodic CAN messages, sent from one timer tick.
+ */
+#include "F2806x_Cla_typedefs.h"
+#include "CAN.h"
+
+#ifndef CAN_SCHEDULE_H_
+#define CAN_SCHEDULE_H_
+
+#define CAN_SCHED_AUTO 0xFFFF // As an offset: let CAN_sched_init pick one
+#define CAN_SCHED_HORIZON 1000 // Ticks looked ahead when staggering
+
+// One periodic message. Fill in the first four fields; the rest belong to the scheduler.
+typedef struct{
+	CAN_ID ID;
+	Uint16 period;		// Ticks
+	Uint16 offset;		// Ticks after the start, or CAN_SCHED_AUTO
+	Uint16 (*producer)(CAN_FRAME* frame); // Fills in length and data (ID is set); return 0 to skip
+
+	Uint32 next;		// Tick it is next due
+	Uint32 due;			// When the frame now in flight was queued, in cycles (see CAN_sched_now)
+	Uint16 pending;		// Queued and not yet gone
+	Uint16 length;		// Of the last frame produced, for CAN_sched_load
+	Uint32 sent;
+	Uint32 missed;		// Still in flight when the next was due, or the queue was full
+	Uint32 latency_min;	// Cycles from queueing to TA, over all sent
+	Uint32 latency_max;
+	Uint32 latency_sum;	// For the mean; wraps after a long while, so reset now and then
+}CAN_SCHED_ENTRY;
+
+void CAN_sched_init(CAN_SCHED_ENTRY* table, Uint16 length);
+void CAN_sched_tick(void);
+Uint32 CAN_sched_now(void);
+void CAN_sched_reset_stats(void);
+float32 CAN_sched_load(float32 tick_ms, float32 baud_kbps);
+
+#endif /* CAN_SCHEDULE_H_ */
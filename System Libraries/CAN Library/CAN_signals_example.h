@@ -0,0 +1,338 @@
+/*
+ * CAN_signals_example.h
+ *
+ * Generated by cangen.py from CAN_signals_example.dbc. Do not edit; change the DBC and regenerate.
+ *
+ * NAME_pack/NAME_unpack take the MDL and MDH words of a frame (from a mailbox, a CAN_FRAME,
+ * or the dataL/dataH an upon_receive_isr is given).
+ */
+#include "F2806x_Cla_typedefs.h"
+
+#ifndef CAN_SIGNALS_EXAMPLE_H_
+#define CAN_SIGNALS_EXAMPLE_H_
+
+typedef union{
+	float32 f;
+	Uint32 i;
+}CAN_SIGNALS_FLOAT;
+
+static inline Uint32 CAN_signals_swap(Uint32 v){
+	return (v >> 24) | ((v >> 8) & 0x0000FF00) | ((v << 8) & 0x00FF0000) | (v << 24);
+}
+
+/**********************************************************************
+ * MOTOR_CONTROLLER, sent by MOTOR_CONTROLLER
+ **********************************************************************/
+#define MOTOR_CONTROLLER_ID 0
+#define MOTOR_CONTROLLER_DLC 8
+#define MOTOR_CONTROLLER_SPEED_SCALE 1
+#define MOTOR_CONTROLLER_SPEED_OFFSET 0
+#define MOTOR_CONTROLLER_SPEED_PHYS(raw) ((raw)*MOTOR_CONTROLLER_SPEED_SCALE + MOTOR_CONTROLLER_SPEED_OFFSET) // rpm
+#define MOTOR_CONTROLLER_SPEED_RAW(x) (((x) - MOTOR_CONTROLLER_SPEED_OFFSET)/MOTOR_CONTROLLER_SPEED_SCALE)
+#define MOTOR_CONTROLLER_CURRENT_SCALE 0.01f
+#define MOTOR_CONTROLLER_CURRENT_OFFSET 0
+#define MOTOR_CONTROLLER_CURRENT_PHYS(raw) ((raw)*MOTOR_CONTROLLER_CURRENT_SCALE + MOTOR_CONTROLLER_CURRENT_OFFSET) // A
+#define MOTOR_CONTROLLER_CURRENT_RAW(x) (((x) - MOTOR_CONTROLLER_CURRENT_OFFSET)/MOTOR_CONTROLLER_CURRENT_SCALE)
+#define MOTOR_CONTROLLER_BUS_VOLTAGE_SCALE 0.01f
+#define MOTOR_CONTROLLER_BUS_VOLTAGE_OFFSET 0
+#define MOTOR_CONTROLLER_BUS_VOLTAGE_PHYS(raw) ((raw)*MOTOR_CONTROLLER_BUS_VOLTAGE_SCALE + MOTOR_CONTROLLER_BUS_VOLTAGE_OFFSET) // V
+#define MOTOR_CONTROLLER_BUS_VOLTAGE_RAW(x) (((x) - MOTOR_CONTROLLER_BUS_VOLTAGE_OFFSET)/MOTOR_CONTROLLER_BUS_VOLTAGE_SCALE)
+#define MOTOR_CONTROLLER_TEMPERATURE_SCALE 1
+#define MOTOR_CONTROLLER_TEMPERATURE_OFFSET 0
+#define MOTOR_CONTROLLER_TEMPERATURE_PHYS(raw) ((raw)*MOTOR_CONTROLLER_TEMPERATURE_SCALE + MOTOR_CONTROLLER_TEMPERATURE_OFFSET) // degC
+#define MOTOR_CONTROLLER_TEMPERATURE_RAW(x) (((x) - MOTOR_CONTROLLER_TEMPERATURE_OFFSET)/MOTOR_CONTROLLER_TEMPERATURE_SCALE)
+#define MOTOR_CONTROLLER_FAULT_SCALE 1
+#define MOTOR_CONTROLLER_FAULT_OFFSET 0
+#define MOTOR_CONTROLLER_FAULT_PHYS(raw) ((raw)*MOTOR_CONTROLLER_FAULT_SCALE + MOTOR_CONTROLLER_FAULT_OFFSET) // counts
+#define MOTOR_CONTROLLER_FAULT_RAW(x) (((x) - MOTOR_CONTROLLER_FAULT_OFFSET)/MOTOR_CONTROLLER_FAULT_SCALE)
+
+typedef struct{
+	int16 speed; // rpm
+	int16 current; // A
+	Uint16 bus_voltage; // V
+	int16 temperature; // degC
+	Uint16 fault;
+}MOTOR_CONTROLLER_MSG;
+
+static inline void MOTOR_CONTROLLER_pack(const MOTOR_CONTROLLER_MSG* m, Uint32* dataL, Uint32* dataH){
+	Uint32 l = 0, h = 0;
+	l |= ((Uint32)m->speed & 0xFFFFUL) << 16;
+	l |= ((Uint32)m->current & 0xFFFFUL);
+	h |= ((Uint32)m->bus_voltage & 0xFFFFUL) << 16;
+	h |= ((Uint32)m->temperature & 0xFFUL) << 8;
+	h |= ((Uint32)m->fault & 0xFFUL);
+	*dataL = l;
+	*dataH = h;
+}
+
+static inline void MOTOR_CONTROLLER_unpack(Uint32 dataL, Uint32 dataH, MOTOR_CONTROLLER_MSG* m){
+	m->speed = (int16)((int32)dataL >> 16);
+	m->current = (int16)((int32)(dataL << 16) >> 16);
+	m->bus_voltage = (Uint16)((dataH >> 16) & 0xFFFFUL);
+	m->temperature = (int16)((int32)(dataH << 16) >> 24);
+	m->fault = (Uint16)(dataH & 0xFFUL);
+}
+
+/**********************************************************************
+ * PEDALS, sent by PEDALS
+ **********************************************************************/
+#define PEDALS_ID 1
+#define PEDALS_DLC 4
+#define PEDALS_THROTTLE_SCALE 0.001f
+#define PEDALS_THROTTLE_OFFSET 0
+#define PEDALS_THROTTLE_PHYS(raw) ((raw)*PEDALS_THROTTLE_SCALE + PEDALS_THROTTLE_OFFSET) // counts
+#define PEDALS_THROTTLE_RAW(x) (((x) - PEDALS_THROTTLE_OFFSET)/PEDALS_THROTTLE_SCALE)
+#define PEDALS_BRAKE_SCALE 1
+#define PEDALS_BRAKE_OFFSET 0
+#define PEDALS_BRAKE_PHYS(raw) ((raw)*PEDALS_BRAKE_SCALE + PEDALS_BRAKE_OFFSET) // %
+#define PEDALS_BRAKE_RAW(x) (((x) - PEDALS_BRAKE_OFFSET)/PEDALS_BRAKE_SCALE)
+#define PEDALS_REGEN_SCALE 1
+#define PEDALS_REGEN_OFFSET 0
+#define PEDALS_REGEN_PHYS(raw) ((raw)*PEDALS_REGEN_SCALE + PEDALS_REGEN_OFFSET) // counts
+#define PEDALS_REGEN_RAW(x) (((x) - PEDALS_REGEN_OFFSET)/PEDALS_REGEN_SCALE)
+#define PEDALS_CRUISE_SCALE 1
+#define PEDALS_CRUISE_OFFSET 0
+#define PEDALS_CRUISE_PHYS(raw) ((raw)*PEDALS_CRUISE_SCALE + PEDALS_CRUISE_OFFSET) // counts
+#define PEDALS_CRUISE_RAW(x) (((x) - PEDALS_CRUISE_OFFSET)/PEDALS_CRUISE_SCALE)
+
+typedef struct{
+	Uint16 throttle;
+	Uint16 brake; // %
+	Uint16 regen;
+	Uint16 cruise;
+}PEDALS_MSG;
+
+static inline void PEDALS_pack(const PEDALS_MSG* m, Uint32* dataL, Uint32* dataH){
+	Uint32 l = 0, h = 0;
+	l |= ((Uint32)m->throttle & 0xFFFFUL) << 16;
+	l |= ((Uint32)m->brake & 0xFFUL) << 8;
+	l |= ((Uint32)m->regen & 0x1UL) << 7;
+	l |= ((Uint32)m->cruise & 0x1UL) << 6;
+	*dataL = l;
+	*dataH = h;
+}
+
+static inline void PEDALS_unpack(Uint32 dataL, Uint32 dataH, PEDALS_MSG* m){
+	m->throttle = (Uint16)((dataL >> 16) & 0xFFFFUL);
+	m->brake = (Uint16)((dataL >> 8) & 0xFFUL);
+	m->regen = (Uint16)((dataL >> 7) & 0x1UL);
+	m->cruise = (Uint16)((dataL >> 6) & 0x1UL);
+}
+
+/**********************************************************************
+ * BMS, sent by BMS
+ **********************************************************************/
+#define BMS_ID 2
+#define BMS_DLC 8
+#define BMS_PACK_VOLTAGE_SCALE 0.01f
+#define BMS_PACK_VOLTAGE_OFFSET 0
+#define BMS_PACK_VOLTAGE_PHYS(raw) ((raw)*BMS_PACK_VOLTAGE_SCALE + BMS_PACK_VOLTAGE_OFFSET) // V
+#define BMS_PACK_VOLTAGE_RAW(x) (((x) - BMS_PACK_VOLTAGE_OFFSET)/BMS_PACK_VOLTAGE_SCALE)
+#define BMS_PACK_CURRENT_SCALE 0.01f
+#define BMS_PACK_CURRENT_OFFSET 0
+#define BMS_PACK_CURRENT_PHYS(raw) ((raw)*BMS_PACK_CURRENT_SCALE + BMS_PACK_CURRENT_OFFSET) // A
+#define BMS_PACK_CURRENT_RAW(x) (((x) - BMS_PACK_CURRENT_OFFSET)/BMS_PACK_CURRENT_SCALE)
+#define BMS_SOC_SCALE 0.5f
+#define BMS_SOC_OFFSET 0
+#define BMS_SOC_PHYS(raw) ((raw)*BMS_SOC_SCALE + BMS_SOC_OFFSET) // %
+#define BMS_SOC_RAW(x) (((x) - BMS_SOC_OFFSET)/BMS_SOC_SCALE)
+#define BMS_MAX_CELL_TEMP_SCALE 1
+#define BMS_MAX_CELL_TEMP_OFFSET 0
+#define BMS_MAX_CELL_TEMP_PHYS(raw) ((raw)*BMS_MAX_CELL_TEMP_SCALE + BMS_MAX_CELL_TEMP_OFFSET) // degC
+#define BMS_MAX_CELL_TEMP_RAW(x) (((x) - BMS_MAX_CELL_TEMP_OFFSET)/BMS_MAX_CELL_TEMP_SCALE)
+#define BMS_MIN_CELL_VOLTAGE_SCALE 0.02f
+#define BMS_MIN_CELL_VOLTAGE_OFFSET 0
+#define BMS_MIN_CELL_VOLTAGE_PHYS(raw) ((raw)*BMS_MIN_CELL_VOLTAGE_SCALE + BMS_MIN_CELL_VOLTAGE_OFFSET) // V
+#define BMS_MIN_CELL_VOLTAGE_RAW(x) (((x) - BMS_MIN_CELL_VOLTAGE_OFFSET)/BMS_MIN_CELL_VOLTAGE_SCALE)
+#define BMS_FAULT_SCALE 1
+#define BMS_FAULT_OFFSET 0
+#define BMS_FAULT_PHYS(raw) ((raw)*BMS_FAULT_SCALE + BMS_FAULT_OFFSET) // counts
+#define BMS_FAULT_RAW(x) (((x) - BMS_FAULT_OFFSET)/BMS_FAULT_SCALE)
+
+typedef struct{
+	Uint16 pack_voltage; // V
+	int16 pack_current; // A
+	Uint16 soc; // %
+	int16 max_cell_temp; // degC
+	Uint16 min_cell_voltage; // V
+	Uint16 fault;
+}BMS_MSG;
+
+static inline void BMS_pack(const BMS_MSG* m, Uint32* dataL, Uint32* dataH){
+	Uint32 l = 0, h = 0;
+	l |= ((Uint32)m->pack_voltage & 0xFFFFUL) << 16;
+	l |= ((Uint32)m->pack_current & 0xFFFFUL);
+	h |= ((Uint32)m->soc & 0xFFUL) << 24;
+	h |= ((Uint32)m->max_cell_temp & 0xFFUL) << 16;
+	h |= ((Uint32)m->min_cell_voltage & 0xFFUL) << 8;
+	h |= ((Uint32)m->fault & 0xFFUL);
+	*dataL = l;
+	*dataH = h;
+}
+
+static inline void BMS_unpack(Uint32 dataL, Uint32 dataH, BMS_MSG* m){
+	m->pack_voltage = (Uint16)((dataL >> 16) & 0xFFFFUL);
+	m->pack_current = (int16)((int32)(dataL << 16) >> 16);
+	m->soc = (Uint16)((dataH >> 24) & 0xFFUL);
+	m->max_cell_temp = (int16)((int32)(dataH << 8) >> 24);
+	m->min_cell_voltage = (Uint16)((dataH >> 8) & 0xFFUL);
+	m->fault = (Uint16)(dataH & 0xFFUL);
+}
+
+/**********************************************************************
+ * IMU, sent by IMU
+ **********************************************************************/
+#define IMU_ID 3
+#define IMU_DLC 8
+#define IMU_ACCEL_X_SCALE 0.001f
+#define IMU_ACCEL_X_OFFSET 0
+#define IMU_ACCEL_X_PHYS(raw) ((raw)*IMU_ACCEL_X_SCALE + IMU_ACCEL_X_OFFSET) // g
+#define IMU_ACCEL_X_RAW(x) (((x) - IMU_ACCEL_X_OFFSET)/IMU_ACCEL_X_SCALE)
+#define IMU_ACCEL_Y_SCALE 0.001f
+#define IMU_ACCEL_Y_OFFSET 0
+#define IMU_ACCEL_Y_PHYS(raw) ((raw)*IMU_ACCEL_Y_SCALE + IMU_ACCEL_Y_OFFSET) // g
+#define IMU_ACCEL_Y_RAW(x) (((x) - IMU_ACCEL_Y_OFFSET)/IMU_ACCEL_Y_SCALE)
+
+typedef struct{
+	int16 accel_x; // g
+	int16 accel_y; // g
+	float32 yaw_rate; // deg/s
+}IMU_MSG;
+
+static inline void IMU_pack(const IMU_MSG* m, Uint32* dataL, Uint32* dataH){
+	Uint32 l = 0, h = 0;
+	CAN_SIGNALS_FLOAT u;
+	l |= ((Uint32)m->accel_x & 0xFFFFUL) << 16;
+	l |= ((Uint32)m->accel_y & 0xFFFFUL);
+	u.f = m->yaw_rate;
+	h |= u.i;
+	*dataL = l;
+	*dataH = h;
+}
+
+static inline void IMU_unpack(Uint32 dataL, Uint32 dataH, IMU_MSG* m){
+	CAN_SIGNALS_FLOAT u;
+	m->accel_x = (int16)((int32)dataL >> 16);
+	m->accel_y = (int16)((int32)(dataL << 16) >> 16);
+	u.i = dataH;
+	m->yaw_rate = u.f;
+}
+
+/**********************************************************************
+ * WIFI, sent by WIFI
+ **********************************************************************/
+#define WIFI_ID 4
+#define WIFI_DLC 2
+#define WIFI_COMMAND_SCALE 1
+#define WIFI_COMMAND_OFFSET 0
+#define WIFI_COMMAND_PHYS(raw) ((raw)*WIFI_COMMAND_SCALE + WIFI_COMMAND_OFFSET) // counts
+#define WIFI_COMMAND_RAW(x) (((x) - WIFI_COMMAND_OFFSET)/WIFI_COMMAND_SCALE)
+#define WIFI_ARGUMENT_SCALE 1
+#define WIFI_ARGUMENT_OFFSET 0
+#define WIFI_ARGUMENT_PHYS(raw) ((raw)*WIFI_ARGUMENT_SCALE + WIFI_ARGUMENT_OFFSET) // counts
+#define WIFI_ARGUMENT_RAW(x) (((x) - WIFI_ARGUMENT_OFFSET)/WIFI_ARGUMENT_SCALE)
+
+typedef struct{
+	Uint16 command;
+	Uint16 argument;
+}WIFI_MSG;
+
+static inline void WIFI_pack(const WIFI_MSG* m, Uint32* dataL, Uint32* dataH){
+	Uint32 l = 0, h = 0;
+	l |= ((Uint32)m->command & 0xFFUL) << 24;
+	l |= ((Uint32)m->argument & 0xFFUL) << 16;
+	*dataL = l;
+	*dataH = h;
+}
+
+static inline void WIFI_unpack(Uint32 dataL, Uint32 dataH, WIFI_MSG* m){
+	m->command = (Uint16)((dataL >> 24) & 0xFFUL);
+	m->argument = (Uint16)((dataL >> 16) & 0xFFUL);
+}
+
+/**********************************************************************
+ * SCREEN, sent by SCREEN
+ **********************************************************************/
+#define SCREEN_ID 5
+#define SCREEN_DLC 1
+#define SCREEN_PAGE_SCALE 1
+#define SCREEN_PAGE_OFFSET 0
+#define SCREEN_PAGE_PHYS(raw) ((raw)*SCREEN_PAGE_SCALE + SCREEN_PAGE_OFFSET) // counts
+#define SCREEN_PAGE_RAW(x) (((x) - SCREEN_PAGE_OFFSET)/SCREEN_PAGE_SCALE)
+#define SCREEN_ACK_SCALE 1
+#define SCREEN_ACK_OFFSET 0
+#define SCREEN_ACK_PHYS(raw) ((raw)*SCREEN_ACK_SCALE + SCREEN_ACK_OFFSET) // counts
+#define SCREEN_ACK_RAW(x) (((x) - SCREEN_ACK_OFFSET)/SCREEN_ACK_SCALE)
+
+typedef struct{
+	Uint16 page;
+	Uint16 ack;
+}SCREEN_MSG;
+
+static inline void SCREEN_pack(const SCREEN_MSG* m, Uint32* dataL, Uint32* dataH){
+	Uint32 l = 0, h = 0;
+	l |= ((Uint32)m->page & 0xFUL) << 28;
+	l |= ((Uint32)m->ack & 0x1UL) << 27;
+	*dataL = l;
+	*dataH = h;
+}
+
+static inline void SCREEN_unpack(Uint32 dataL, Uint32 dataH, SCREEN_MSG* m){
+	m->page = (Uint16)((dataL >> 28) & 0xFUL);
+	m->ack = (Uint16)((dataL >> 27) & 0x1UL);
+}
+
+/**********************************************************************
+ * MPPT, sent by MPPT
+ **********************************************************************/
+#define MPPT_ID 0x80000600 // 0x600, extended
+#define MPPT_DLC 8
+#define MPPT_INPUT_VOLTAGE_SCALE 0.01f
+#define MPPT_INPUT_VOLTAGE_OFFSET 0
+#define MPPT_INPUT_VOLTAGE_PHYS(raw) ((raw)*MPPT_INPUT_VOLTAGE_SCALE + MPPT_INPUT_VOLTAGE_OFFSET) // V
+#define MPPT_INPUT_VOLTAGE_RAW(x) (((x) - MPPT_INPUT_VOLTAGE_OFFSET)/MPPT_INPUT_VOLTAGE_SCALE)
+#define MPPT_INPUT_CURRENT_SCALE 0.001f
+#define MPPT_INPUT_CURRENT_OFFSET 0
+#define MPPT_INPUT_CURRENT_PHYS(raw) ((raw)*MPPT_INPUT_CURRENT_SCALE + MPPT_INPUT_CURRENT_OFFSET) // A
+#define MPPT_INPUT_CURRENT_RAW(x) (((x) - MPPT_INPUT_CURRENT_OFFSET)/MPPT_INPUT_CURRENT_SCALE)
+#define MPPT_OUTPUT_VOLTAGE_SCALE 0.01f
+#define MPPT_OUTPUT_VOLTAGE_OFFSET 0
+#define MPPT_OUTPUT_VOLTAGE_PHYS(raw) ((raw)*MPPT_OUTPUT_VOLTAGE_SCALE + MPPT_OUTPUT_VOLTAGE_OFFSET) // V
+#define MPPT_OUTPUT_VOLTAGE_RAW(x) (((x) - MPPT_OUTPUT_VOLTAGE_OFFSET)/MPPT_OUTPUT_VOLTAGE_SCALE)
+#define MPPT_TEMPERATURE_SCALE 1
+#define MPPT_TEMPERATURE_OFFSET 0
+#define MPPT_TEMPERATURE_PHYS(raw) ((raw)*MPPT_TEMPERATURE_SCALE + MPPT_TEMPERATURE_OFFSET) // degC
+#define MPPT_TEMPERATURE_RAW(x) (((x) - MPPT_TEMPERATURE_OFFSET)/MPPT_TEMPERATURE_SCALE)
+#define MPPT_STATUS_SCALE 1
+#define MPPT_STATUS_OFFSET 0
+#define MPPT_STATUS_PHYS(raw) ((raw)*MPPT_STATUS_SCALE + MPPT_STATUS_OFFSET) // counts
+#define MPPT_STATUS_RAW(x) (((x) - MPPT_STATUS_OFFSET)/MPPT_STATUS_SCALE)
+
+typedef struct{
+	Uint16 input_voltage; // V
+	Uint16 input_current; // A
+	Uint16 output_voltage; // V
+	int16 temperature; // degC
+	Uint16 status;
+}MPPT_MSG;
+
+static inline void MPPT_pack(const MPPT_MSG* m, Uint32* dataL, Uint32* dataH){
+	Uint32 l = 0, h = 0;
+	l |= ((Uint32)m->input_voltage & 0xFFFFUL) << 16;
+	l |= ((Uint32)m->input_current & 0xFFFFUL);
+	h |= ((Uint32)m->output_voltage & 0xFFFFUL) << 16;
+	h |= ((Uint32)m->temperature & 0xFFUL) << 8;
+	h |= ((Uint32)m->status & 0xFFUL);
+	*dataL = l;
+	*dataH = h;
+}
+
+static inline void MPPT_unpack(Uint32 dataL, Uint32 dataH, MPPT_MSG* m){
+	m->input_voltage = (Uint16)((dataL >> 16) & 0xFFFFUL);
+	m->input_current = (Uint16)(dataL & 0xFFFFUL);
+	m->output_voltage = (Uint16)((dataH >> 16) & 0xFFFFUL);
+	m->temperature = (int16)((int32)(dataH << 16) >> 24);
+	m->status = (Uint16)(dataH & 0xFFUL);
+}
+
+#endif /* CAN_SIGNALS_EXAMPLE_H_ */
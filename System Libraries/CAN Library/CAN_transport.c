@@ -0,0 +1,350 @@
+/*
+ * CAN_transport.c
+ *
+ * Segmented transport for messages up to 4095 bytes, framed like ISO 15765-2 (ISO-TP):
+ *
+ *   Single frame       0x0L  data...              L = length, up to 7 bytes
+ *   First frame        0x1L LL  data...           12-bit length, first 6 bytes
+ *   Consecutive frame  0x2N  data...              N = sequence number, counting 1..15, 0, 1...
+ *   Flow control       0x3S BS ST                 S = 0 go on, 1 wait, 2 too big; BS = frames
+ *                                                 before the next flow control (0 = all);
+ *                                                 ST = ms between consecutive frames
+ *
+ * Every frame of a message goes through CAN_queue on the one ID, so the queue's one-mailbox-per-ID
+ * rule keeps them in order. Consecutive frames are fed in a few at a time by CAN_tp_poll (and by the
+ * flow control that starts each block), never more than half the queue, so a long message doesn't
+ * lock everyone else out.
+ *
+ * Example: a BMS sending 24 cell voltages to the screen
+ *
+ * CAN_TP bms_tp;
+ * Uint16 rx_buf[8]; // The BMS doesn't expect much back
+ * float32 cells[24];
+ *
+ * void bms_receive_isr(CAN_ID ID, Uint32 dataH, Uint32 dataL, Uint16 length, int mbox_num){
+ * 	CAN_tp_on_frame(&bms_tp, dataH, dataL, length, xms);
+ * }
+ * ...
+ * CAN_tp_init(&bms_tp, BMS, SCREEN, rx_buf, 16);
+ * CAN_tp_send(&bms_tp, (Uint16*)cells, 4*24, xms);
+ * while(1){
+ * 	CAN_tp_poll(&bms_tp, xms);
+ * 	...
+ * }
+ *
+ * where xms is any millisecond counter, e.g. bumped from a TimerInit(1) interrupt.
+ */
+#include "DSP28x_Project.h"
+#include "CAN_transport.h"
+
+#define PCI_SINGLE 0x0
+#define PCI_FIRST 0x1
+#define PCI_CONSECUTIVE 0x2
+#define PCI_FLOW 0x3
+
+#define FC_CTS 0
+#define FC_WAIT 1
+#define FC_OVERFLOW 2
+
+// Byte i (0-7) of a frame, in the order it goes on the wire. With CANMC.DBO = 0, as InitECana
+// leaves it, that is the top byte of MDL first.
+static Uint16 CAN_tp_frame_byte(CAN_FRAME* frame, Uint16 i){
+	Uint32 word = (i < 4) ? frame->dataL : frame->dataH;
+	return (Uint16)(word >> (24 - 8*(i & 3))) & 0xFF;
+}
+
+static void CAN_tp_frame_set(CAN_FRAME* frame, Uint16 i, Uint16 value){
+	Uint32* word = (i < 4) ? &frame->dataL : &frame->dataH;
+	Uint16 shift = 24 - 8*(i & 3);
+	*word = (*word & ~((Uint32)0xFF << shift)) | ((Uint32)(value & 0xFF) << shift);
+}
+
+// @brief Byte i of a buffer packed two bytes per word, low byte first (as a Uint32 or float32 lies in memory)
+Uint16 CAN_tp_get_byte(const Uint16* buf, Uint16 i){
+	return (buf[i >> 1] >> (8*(i & 1))) & 0xFF;
+}
+
+void CAN_tp_set_byte(Uint16* buf, Uint16 i, Uint16 value){
+	Uint16 shift = 8*(i & 1);
+	buf[i >> 1] = (buf[i >> 1] & ~(0xFF << shift)) | ((value & 0xFF) << shift);
+}
+
+/*
+ * @brief Set up one end of a connection. rx_buf (rx_size bytes, so rx_size/2 words) receives whole
+ * messages; it is only written between the first frame and upon_receive. Fill in upon_receive,
+ * upon_sent, block_size and stmin afterwards if the defaults (none, none, 0, 0) won't do.
+ * @return 1, or 0 if rx_size is under CAN_TP_MIN_RX; the connection can then send but refuses
+ * everything it is sent
+ */
+Uint16 CAN_tp_init(CAN_TP* tp, CAN_ID tx_id, CAN_ID rx_id, Uint16* rx_buf, Uint16 rx_size){
+	tp->tx_id = tx_id;
+	tp->rx_id = rx_id;
+	tp->block_size = 0;
+	tp->stmin = 0;
+	tp->tx_state = CAN_TP_IDLE;
+	tp->rx_state = CAN_TP_IDLE;
+	tp->rx_buf = rx_buf;
+	tp->rx_size = rx_size;
+	tp->rx_fc_pending = 0;
+	tp->upon_receive = 0;
+	tp->upon_sent = 0;
+	tp->errors = 0;
+	if (rx_size < CAN_TP_MIN_RX){
+		tp->rx_size = 0;
+		return 0;
+	}
+	return 1;
+}
+
+// @brief Queue a flow control frame, or remember to try again from CAN_tp_poll.
+static void CAN_tp_flow(CAN_TP* tp, Uint16 status){
+	CAN_FRAME frame;
+
+	frame.ID = tp->tx_id;
+	frame.length = 3;
+	frame.dataL = 0;
+	frame.dataH = 0;
+	CAN_tp_frame_set(&frame, 0, (PCI_FLOW << 4) | status);
+	CAN_tp_frame_set(&frame, 1, tp->block_size);
+	CAN_tp_frame_set(&frame, 2, tp->stmin);
+	tp->rx_fc_pending = CAN_queue(&frame) ? 0 : status + 1;
+}
+
+// @brief Queue as many consecutive frames as flow control, stmin and the queue allow.
+static void CAN_tp_pump(CAN_TP* tp, Uint32 now){
+	CAN_FRAME frame;
+	Uint16 i, n;
+
+	while (tp->tx_state == CAN_TP_SENDING){
+		if (tp->tx_stmin && now - tp->tx_last < tp->tx_stmin){
+			return;
+		}
+		if (CAN_tx_pending() >= CAN_TX_QUEUE_SIZE/2){
+			return;
+		}
+
+		frame.ID = tp->tx_id;
+		frame.dataL = 0;
+		frame.dataH = 0;
+		n = tp->tx_length - tp->tx_pos;
+		if (n > 7){
+			n = 7;
+		}
+		frame.length = n + 1;
+		CAN_tp_frame_set(&frame, 0, (PCI_CONSECUTIVE << 4) | tp->tx_seq);
+		for (i=0; i<n; i++){
+			CAN_tp_frame_set(&frame, i + 1, CAN_tp_get_byte(tp->tx_data, tp->tx_pos + i));
+		}
+		if (!CAN_queue(&frame)){
+			return; // Try again next poll
+		}
+
+		tp->tx_pos += n;
+		tp->tx_seq = (tp->tx_seq + 1) & 0xF;
+		tp->tx_last = now;
+		if (tp->tx_pos >= tp->tx_length){
+			tp->tx_state = CAN_TP_IDLE;
+			if (tp->upon_sent){
+				tp->upon_sent(tp);
+			}
+		}
+		else if (tp->tx_block_left && --tp->tx_block_left == 0){
+			tp->tx_state = CAN_TP_WAIT_FC;
+		}
+		if (tp->tx_stmin){
+			return; // One per stmin
+		}
+	}
+}
+
+/*
+ * @brief Start sending length bytes of data (two bytes per word, low byte first). data must stay put
+ * until upon_sent, which is called once the last frame has been queued.
+ * Returns 1 if started, 0 if a message is already going out, length is too long, or the queue is full.
+ */
+Uint16 CAN_tp_send(CAN_TP* tp, const Uint16* data, Uint16 length, Uint32 now){
+	CAN_FRAME frame;
+	Uint16 i, n, ok;
+	Uint16 intm = __disable_interrupts();
+
+	if (tp->tx_state != CAN_TP_IDLE || length > CAN_TP_MAX_LENGTH){
+		__restore_interrupts(intm);
+		return 0;
+	}
+
+	frame.ID = tp->tx_id;
+	frame.dataL = 0;
+	frame.dataH = 0;
+	if (length <= 7){
+		frame.length = length + 1;
+		CAN_tp_frame_set(&frame, 0, (PCI_SINGLE << 4) | length);
+		for (i=0; i<length; i++){
+			CAN_tp_frame_set(&frame, i + 1, CAN_tp_get_byte(data, i));
+		}
+		ok = CAN_queue(&frame);
+		__restore_interrupts(intm);
+		if (ok && tp->upon_sent){
+			tp->upon_sent(tp);
+		}
+		return ok;
+	}
+
+	n = 6;
+	frame.length = 8;
+	CAN_tp_frame_set(&frame, 0, (PCI_FIRST << 4) | (length >> 8));
+	CAN_tp_frame_set(&frame, 1, length);
+	for (i=0; i<n; i++){
+		CAN_tp_frame_set(&frame, i + 2, CAN_tp_get_byte(data, i));
+	}
+	ok = CAN_queue(&frame);
+	if (ok){
+		tp->tx_data = data;
+		tp->tx_length = length;
+		tp->tx_pos = n;
+		tp->tx_seq = 1;
+		tp->tx_last = now;
+		tp->tx_state = CAN_TP_WAIT_FC;
+	}
+	__restore_interrupts(intm);
+	return ok;
+}
+
+/*
+ * @brief Feed this every frame that arrives on rx_id, e.g. from that CAN_INFO's upon_receive_isr.
+ * now is the same millisecond count given to CAN_tp_poll.
+ */
+void CAN_tp_on_frame(CAN_TP* tp, Uint32 dataH, Uint32 dataL, Uint16 length, Uint32 now){
+	CAN_FRAME frame;
+	Uint16 pci, i, n;
+
+	if (length == 0){
+		return;
+	}
+	frame.dataL = dataL;
+	frame.dataH = dataH;
+	pci = CAN_tp_frame_byte(&frame, 0);
+
+	switch (pci >> 4){
+	case PCI_FLOW:
+		if (tp->tx_state != CAN_TP_WAIT_FC || length < 3){
+			return;
+		}
+		switch (pci & 0xF){
+		case FC_CTS:
+			tp->tx_block_left = CAN_tp_frame_byte(&frame, 1);
+			n = CAN_tp_frame_byte(&frame, 2);
+			tp->tx_stmin = (n <= 127) ? n : 1; // 0xF1-0xF9 are 100-900us; round up to 1ms
+			tp->tx_last = now - tp->tx_stmin; // The first one can go right away
+			tp->tx_state = CAN_TP_SENDING;
+			CAN_tp_pump(tp, now);
+			break;
+		case FC_WAIT:
+			tp->tx_last = now; // Restart the timeout
+			break;
+		default: // Overflow, or nonsense
+			tp->tx_state = CAN_TP_IDLE;
+			tp->errors++;
+			break;
+		}
+		return;
+
+	case PCI_SINGLE:
+		n = pci & 0xF;
+		if (tp->rx_state == CAN_TP_RECEIVING){
+			tp->errors++; // A new message abandons the old one
+			tp->rx_state = CAN_TP_IDLE;
+		}
+		if (n == 0 || n > 7 || n >= length || n > tp->rx_size){
+			tp->errors++;
+			return;
+		}
+		for (i=0; i<n; i++){
+			CAN_tp_set_byte(tp->rx_buf, i, CAN_tp_frame_byte(&frame, i + 1));
+		}
+		if (tp->upon_receive){
+			tp->upon_receive(tp, n);
+		}
+		return;
+
+	case PCI_FIRST:
+		if (tp->rx_state == CAN_TP_RECEIVING){
+			tp->errors++;
+		}
+		tp->rx_state = CAN_TP_IDLE;
+		n = ((pci & 0xF) << 8) | CAN_tp_frame_byte(&frame, 1);
+		if (n < 8 || length < 8){ // Would have fitted a single frame: ISO 15765-2 says ignore it
+			tp->errors++;
+			return;
+		}
+		if (n > tp->rx_size){
+			tp->errors++;
+			CAN_tp_flow(tp, FC_OVERFLOW);
+			return;
+		}
+		for (i=0; i<6; i++){
+			CAN_tp_set_byte(tp->rx_buf, i, CAN_tp_frame_byte(&frame, i + 2));
+		}
+		tp->rx_length = n;
+		tp->rx_pos = 6;
+		tp->rx_seq = 1;
+		tp->rx_block_left = tp->block_size;
+		tp->rx_last = now;
+		tp->rx_state = CAN_TP_RECEIVING;
+		CAN_tp_flow(tp, FC_CTS);
+		return;
+
+	case PCI_CONSECUTIVE:
+		if (tp->rx_state != CAN_TP_RECEIVING){
+			return;
+		}
+		if ((pci & 0xF) != tp->rx_seq){
+			tp->errors++; // Lost a frame; the message is no good
+			tp->rx_state = CAN_TP_IDLE;
+			return;
+		}
+		n = tp->rx_length - tp->rx_pos;
+		if (n > 7){
+			n = 7;
+		}
+		for (i=0; i<n; i++){
+			CAN_tp_set_byte(tp->rx_buf, tp->rx_pos + i, CAN_tp_frame_byte(&frame, i + 1));
+		}
+		tp->rx_pos += n;
+		tp->rx_seq = (tp->rx_seq + 1) & 0xF;
+		tp->rx_last = now;
+		if (tp->rx_pos >= tp->rx_length){
+			tp->rx_state = CAN_TP_IDLE;
+			if (tp->upon_receive){
+				tp->upon_receive(tp, tp->rx_length);
+			}
+		}
+		else if (tp->block_size && --tp->rx_block_left == 0){
+			tp->rx_block_left = tp->block_size;
+			CAN_tp_flow(tp, FC_CTS);
+		}
+		return;
+	}
+}
+
+/*
+ * @brief Call often (every millisecond or so) from the main loop: sends consecutive frames as the
+ * queue and stmin allow, retries flow control that didn't fit in the queue, and gives up on
+ * connections that have been quiet for CAN_TP_TIMEOUT ms.
+ */
+void CAN_tp_poll(CAN_TP* tp, Uint32 now){
+	Uint16 intm = __disable_interrupts();
+
+	if (tp->rx_fc_pending){
+		CAN_tp_flow(tp, tp->rx_fc_pending - 1);
+	}
+	if (tp->tx_state == CAN_TP_WAIT_FC && now - tp->tx_last > CAN_TP_TIMEOUT){
+		tp->tx_state = CAN_TP_IDLE;
+		tp->errors++;
+	}
+	if (tp->rx_state == CAN_TP_RECEIVING && now - tp->rx_last > CAN_TP_TIMEOUT){
+		tp->rx_state = CAN_TP_IDLE;
+		tp->errors++;
+	}
+	CAN_tp_pump(tp, now);
+	__restore_interrupts(intm);
+}
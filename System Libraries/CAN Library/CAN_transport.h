@@ -0,0 +1,65 @@
+/*
+ * CAN_transport.h
+ *
+ * Messages longer than 8 bytes, split ISO-TP style into a first frame,
+ * numbered consecutive frames, and flow control from the receiver.
+ */
+#include "F2806x_Cla_typedefs.h"
+#include "CAN.h"
+
+#ifndef CAN_TRANSPORT_H_
+#define CAN_TRANSPORT_H_
+
+#define CAN_TP_MAX_LENGTH 4095 // A first frame has 12 bits of length
+#define CAN_TP_MIN_RX 8 // Smallest rx_buf, in bytes: a first frame always carries 6 and announces at least 8
+#define CAN_TP_TIMEOUT 1000 // ms to wait for the next flow control or consecutive frame
+
+typedef enum{
+	CAN_TP_IDLE,
+	CAN_TP_WAIT_FC,		// Sent a first frame, or finished a block; waiting for the receiver
+	CAN_TP_SENDING,		// Allowed to send consecutive frames
+	CAN_TP_RECEIVING
+}CAN_TP_STATE;
+
+// One end of a transport connection. Data is sent on tx_id; frames from the other end (its data,
+// and its flow control for what we send) arrive on rx_id. Sending and receiving can overlap.
+typedef struct CAN_TP_STRUCT{
+	CAN_ID tx_id;
+	CAN_ID rx_id;
+	Uint16 block_size;		// Consecutive frames we accept between flow controls (0 = all)
+	Uint16 stmin;			// ms we ask senders to leave between consecutive frames
+
+	// Sending
+	CAN_TP_STATE tx_state;
+	const Uint16* tx_data;	// Two bytes per word, low byte first
+	Uint16 tx_length;		// Bytes
+	Uint16 tx_pos;
+	Uint16 tx_seq;
+	Uint16 tx_block_left;	// 0 = unlimited
+	Uint16 tx_stmin;
+	Uint32 tx_last;			// When we last sent or heard something, in ms
+
+	// Receiving
+	CAN_TP_STATE rx_state;
+	Uint16* rx_buf;			// Preallocated by the user, two bytes per word
+	Uint16 rx_size;			// Bytes it can hold
+	Uint16 rx_length;
+	Uint16 rx_pos;
+	Uint16 rx_seq;
+	Uint16 rx_block_left;
+	Uint16 rx_fc_pending;	// Flow control to send (FS value + 1), if the queue was full
+	Uint32 rx_last;
+
+	void (*upon_receive)(struct CAN_TP_STRUCT* tp, Uint16 length); // From ecan_isr: rx_buf holds a message
+	void (*upon_sent)(struct CAN_TP_STRUCT* tp);		// From CAN_tp_poll or ecan_isr
+	Uint32 errors;			// Sequence errors, timeouts, overflows, aborts
+}CAN_TP;
+
+Uint16 CAN_tp_init(CAN_TP* tp, CAN_ID tx_id, CAN_ID rx_id, Uint16* rx_buf, Uint16 rx_size);
+Uint16 CAN_tp_send(CAN_TP* tp, const Uint16* data, Uint16 length, Uint32 now);
+void CAN_tp_on_frame(CAN_TP* tp, Uint32 dataH, Uint32 dataL, Uint16 length, Uint32 now);
+void CAN_tp_poll(CAN_TP* tp, Uint32 now);
+Uint16 CAN_tp_get_byte(const Uint16* buf, Uint16 i);
+void CAN_tp_set_byte(Uint16* buf, Uint16 i, Uint16 value);
+
+#endif /* CAN_TRANSPORT_H_ */
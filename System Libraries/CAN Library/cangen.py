@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+"""
+Generate CAN_signals.h from CAN_signals.dbc.
+
+    python3 cangen.py [CAN_signals.dbc [CAN_signals.h]]
+
+CAN_signals_example.dbc shows the format. Its layouts are made up, so only
+messages checked against their node's firmware belong in CAN_signals.dbc.
+CAN_signals_example.h is generated from it with
+
+    python3 cangen.py CAN_signals_example.dbc CAN_signals_example.h
+
+For every BO_ (message) in the DBC this writes
+  - NAME_ID and NAME_DLC (extended IDs keep bit 31 set, matching CAN_EXT),
+  - a NAME_MSG struct with one field per signal, holding raw counts (or the
+    float itself for IEEE signals),
+  - NAME_SIGNAL_SCALE/OFFSET and NAME_SIGNAL_PHYS(raw)/RAW(x) conversions,
+  - static inline NAME_pack() and NAME_unpack(), which move every field in or
+    out of MDL/MDH with constant shifts and masks.
+
+Only the subset of DBC the file uses is understood: BO_, SG_ and
+SIG_VALTYPE_ (float signals). Multiplexed signals are not supported.
+"""
+import re
+import sys
+
+BO_RE = re.compile(r'^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+)')
+SG_RE = re.compile(r'^SG_\s+(\w+)\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*'
+                   r'\(([^,]+),([^)]+)\)\s*\[([^|]*)\|([^\]]*)\]\s*"([^"]*)"')
+VT_RE = re.compile(r'^SIG_VALTYPE_\s+(\d+)\s+(\w+)\s*:\s*(\d)\s*;')
+
+
+class Signal:
+    def __init__(self, name, start, length, intel, signed, scale, offset, unit):
+        self.name = name
+        self.start = start
+        self.length = length
+        self.intel = intel
+        self.signed = signed
+        self.scale = scale
+        self.offset = offset
+        self.unit = unit
+        self.is_float = False
+
+    def position(self):
+        """Which word the signal lives in, and the shift of its lsb there.
+
+        Motorola signals are read from MDL:MDH as one big-endian 64-bit
+        number. Intel signals are read from the byte-swapped words, which
+        makes the payload one little-endian number, swapL:swapH.
+        """
+        if self.intel:
+            lsb = self.start
+            word, shift = ('H', lsb - 32) if lsb >= 32 else ('L', lsb)
+        else:
+            byte, bit = self.start >> 3, self.start & 7
+            lsb = (7 - byte) * 8 + bit - (self.length - 1)
+            word, shift = ('L', lsb - 32) if lsb >= 32 else ('H', lsb)
+        if shift < 0 or shift + self.length > 32:
+            raise ValueError('%s crosses between MDL and MDH; move or split it' % self.name)
+        return word, shift
+
+    def ctype(self):
+        if self.is_float:
+            return 'float32'
+        if self.length <= 16:
+            return 'int16' if self.signed else 'Uint16'
+        return 'int32' if self.signed else 'Uint32'
+
+
+class Message:
+    def __init__(self, ident, name, dlc, sender):
+        self.ident = ident
+        self.name = name
+        self.dlc = dlc
+        self.sender = sender
+        self.signals = []
+
+
+def parse(path):
+    messages = []
+    by_id = {}
+    with open(path) as f:
+        for raw in f:
+            line = raw.strip()
+            m = BO_RE.match(line)
+            if m:
+                msg = Message(int(m.group(1)), m.group(2), int(m.group(3)), m.group(4))
+                messages.append(msg)
+                by_id[msg.ident] = msg
+                continue
+            m = SG_RE.match(line)
+            if m:
+                if not messages:
+                    raise ValueError('SG_ before any BO_: ' + line)
+                messages[-1].signals.append(Signal(
+                    m.group(1), int(m.group(2)), int(m.group(3)), m.group(4) == '1',
+                    m.group(5) == '-', float(m.group(6)), float(m.group(7)), m.group(10)))
+                continue
+            m = VT_RE.match(line)
+            if m and m.group(3) == '1':
+                msg = by_id[int(m.group(1))]
+                sig = [s for s in msg.signals if s.name == m.group(2)][0]
+                if sig.length != 32:
+                    raise ValueError('%s: float signals must be 32 bits' % sig.name)
+                sig.is_float = True
+    return messages
+
+
+def num(x):
+    """A float literal the C28x compiler won't promote to double arithmetic by surprise."""
+    return repr(float(x)) + 'f' if x != int(x) else '%d' % x
+
+
+def emit(messages, dbc_name, header_name):
+    guard = re.sub(r'\W', '_', header_name).upper() + '_'
+    out = []
+    w = out.append
+    w('/*')
+    w(' * %s' % header_name)
+    w(' *')
+    w(' * Generated by cangen.py from %s. Do not edit; change the DBC and regenerate.' % dbc_name)
+    w(' *')
+    w(' * NAME_pack/NAME_unpack take the MDL and MDH words of a frame (from a mailbox, a CAN_FRAME,')
+    w(' * or the dataL/dataH an upon_receive_isr is given).')
+    w(' */')
+    w('#include "F2806x_Cla_typedefs.h"')
+    w('')
+    w('#ifndef %s' % guard)
+    w('#define %s' % guard)
+    w('')
+    w('typedef union{')
+    w('\tfloat32 f;')
+    w('\tUint32 i;')
+    w('}CAN_SIGNALS_FLOAT;')
+    w('')
+    w('static inline Uint32 CAN_signals_swap(Uint32 v){')
+    w('\treturn (v >> 24) | ((v >> 8) & 0x0000FF00) | ((v << 8) & 0x00FF0000) | (v << 24);')
+    w('}')
+    for msg in messages:
+        up = msg.name.upper()
+        intel = any(s.intel for s in msg.signals)
+        motorola = any(not s.intel for s in msg.signals)
+        w('')
+        w('/' + '*' * 70)
+        w(' * %s, sent by %s' % (msg.name, msg.sender))
+        w(' ' + '*' * 70 + '/')
+        if msg.ident & 0x80000000:
+            w('#define %s_ID 0x%08X // 0x%X, extended' % (up, msg.ident, msg.ident & 0x1FFFFFFF))
+        else:
+            w('#define %s_ID %d' % (up, msg.ident))
+        w('#define %s_DLC %d' % (up, msg.dlc))
+        for s in msg.signals:
+            if not s.is_float:
+                sn = '%s_%s' % (up, s.name.upper())
+                w('#define %s_SCALE %s' % (sn, num(s.scale)))
+                w('#define %s_OFFSET %s' % (sn, num(s.offset)))
+                w('#define %s_PHYS(raw) ((raw)*%s_SCALE + %s_OFFSET) // %s' % (sn, sn, sn, s.unit or 'counts'))
+                w('#define %s_RAW(x) (((x) - %s_OFFSET)/%s_SCALE)' % (sn, sn, sn))
+        w('')
+        w('typedef struct{')
+        for s in msg.signals:
+            unit = (' // %s' % s.unit) if s.unit else ''
+            w('\t%s %s;%s' % (s.ctype(), s.name, unit))
+        w('}%s_MSG;' % up)
+        w('')
+
+        # pack
+        w('static inline void %s_pack(const %s_MSG* m, Uint32* dataL, Uint32* dataH){' % (up, up))
+        w('\tUint32 l = 0, h = 0;')
+        if intel:
+            w('\tUint32 sl = 0, sh = 0;')
+        if any(s.is_float for s in msg.signals):
+            w('\tCAN_SIGNALS_FLOAT u;')
+        for s in msg.signals:
+            word, shift = s.position()
+            dst = ('s' if s.intel else '') + word.lower()
+            mask = (1 << s.length) - 1
+            if s.is_float:
+                w('\tu.f = m->%s;' % s.name)
+                val = 'u.i'
+            else:
+                val = '(Uint32)m->%s' % s.name
+            if s.length < 32:
+                val = '(%s & 0x%XUL)' % (val, mask)
+            w('\t%s |= %s%s;' % (dst, val, (' << %d' % shift) if shift else ''))
+        if intel:
+            w('\tl |= CAN_signals_swap(sl);')
+            w('\th |= CAN_signals_swap(sh);')
+        w('\t*dataL = l;')
+        w('\t*dataH = h;')
+        w('}')
+        w('')
+
+        # unpack
+        w('static inline void %s_unpack(Uint32 dataL, Uint32 dataH, %s_MSG* m){' % (up, up))
+        if intel:
+            w('\tUint32 sl = CAN_signals_swap(dataL);')
+            w('\tUint32 sh = CAN_signals_swap(dataH);')
+        if any(s.is_float for s in msg.signals):
+            w('\tCAN_SIGNALS_FLOAT u;')
+        for s in msg.signals:
+            word, shift = s.position()
+            src = ('s' + word.lower()) if s.intel else ('data' + word)
+            mask = (1 << s.length) - 1
+            if s.is_float:
+                expr = ('%s >> %d' % (src, shift)) if shift else src
+                w('\tu.i = %s;' % expr)
+                w('\tm->%s = u.f;' % s.name)
+            elif s.signed:
+                # Move the field to the top of the word, then arithmetic-shift it back down
+                up_shift = 32 - shift - s.length
+                expr = ('(%s << %d)' % (src, up_shift)) if up_shift else src
+                w('\tm->%s = (%s)((int32)%s >> %d);' % (s.name, s.ctype(), expr, 32 - s.length))
+            else:
+                expr = ('(%s >> %d)' % (src, shift)) if shift else src
+                if s.length < 32:
+                    expr = '(%s & 0x%XUL)' % (expr, mask)
+                w('\tm->%s = (%s)%s;' % (s.name, s.ctype(), expr))
+        w('}')
+    w('')
+    w('#endif /* %s */' % guard)
+    return '\n'.join(out) + '\n'
+
+
+def main():
+    dbc = sys.argv[1] if len(sys.argv) > 1 else 'CAN_signals.dbc'
+    header = sys.argv[2] if len(sys.argv) > 2 else 'CAN_signals.h'
+    text = emit(parse(dbc), dbc.replace('\\', '/').split('/')[-1],
+                header.replace('\\', '/').split('/')[-1])
+    with open(header, 'w', newline='\r\n') as f:
+        f.write(text)
+
+
+if __name__ == '__main__':
+    main()
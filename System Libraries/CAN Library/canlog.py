@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""
+Decode a receive log written by CAN_log_drain (see CAN_log.c).
+
+    python3 canlog.py capture.bin [--kbps 500] [--latency 1 0]
+
+capture.bin is the raw bytes from the serial port, e.g.
+    stty -F /dev/ttyUSB0 115200 raw && cat /dev/ttyUSB0 > capture.bin
+
+Prints one CSV line per frame: time in us since the first frame, mailbox, ID,
+length and data. Records that fail their checksum are skipped by searching for
+the next mark, and gaps in the sequence numbers are reported as dropped frames.
+
+--latency A B times, for every frame with ID A, how long until the next frame
+with ID B (IDs as in CAN.h: PEDALS is 1, MOTOR_CONTROLLER 0), and prints the
+min, mean and max at the end.
+"""
+import argparse
+import sys
+
+MARK = 0xC4
+RECORD = 21
+
+
+def records(data):
+    """Yield (seq, length, mbox, stamp, ident, payload) for every good record."""
+    i = 0
+    while i + RECORD <= len(data):
+        rec = data[i:i + RECORD]
+        if rec[0] != MARK or sum(rec[:-1]) & 0xFF != rec[-1]:
+            i += 1
+            continue
+        seq, length, mbox = rec[1], rec[2], rec[3]
+        stamp = int.from_bytes(rec[4:8], 'little')
+        ident = int.from_bytes(rec[8:12], 'little')
+        yield seq, length, mbox, stamp, ident, rec[12:12 + min(length, 8)]
+        i += RECORD
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument('log')
+    ap.add_argument('--kbps', type=float, default=500, help='CAN bit rate; the timestamp counts bits')
+    ap.add_argument('--latency', nargs=2, type=lambda s: int(s, 0), metavar=('A', 'B'))
+    args = ap.parse_args()
+
+    with open(args.log, 'rb') as f:
+        data = f.read()
+
+    us_per_tick = 1000.0 / args.kbps
+    out = sys.stdout
+    out.write('time_us,mbox,id,length,data\n')
+    first = last_stamp = last_seq = None
+    elapsed = 0
+    dropped = frames = 0
+    waiting = None  # When the last unanswered A frame arrived
+    latencies = []
+    for seq, length, mbox, stamp, ident, payload in records(data):
+        if last_seq is not None:
+            dropped += (seq - last_seq - 1) & 0xFF
+        last_seq = seq
+        if first is None:
+            first = stamp
+        else:
+            elapsed += (stamp - last_stamp) & 0xFFFFFFFF  # The counter wraps
+        last_stamp = stamp
+        frames += 1
+        t = elapsed * us_per_tick
+        out.write('%.1f,%d,0x%X,%d,%s\n' % (t, mbox, ident, length, payload.hex()))
+
+        if args.latency:
+            a, b = args.latency
+            if ident == b and waiting is not None:
+                latencies.append(t - waiting)
+                waiting = None
+            if ident == a and waiting is None:
+                waiting = t
+
+    sys.stderr.write('%d frames, %d dropped\n' % (frames, dropped))
+    if args.latency:
+        if latencies:
+            sys.stderr.write('latency 0x%X -> 0x%X over %d: min %.1f us, mean %.1f us, max %.1f us\n' % (
+                args.latency[0], args.latency[1], len(latencies), min(latencies),
+                sum(latencies) / len(latencies), max(latencies)))
+        else:
+            sys.stderr.write('no 0x%X frame was followed by a 0x%X\n' % tuple(args.latency))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,154 @@
+/**
+ * @file cla.c
+ * @brief A library that hands per-sample work to the Control Law Accelerator
+ * @ingroup Digital
+ * @version 0
+ *
+ * http://solarracing.gatech.edu/wiki/Main_Page
+ * The CLA is a second, floating-point core that runs small tasks in response
+ * to ADC or ePWM interrupts, without the CPU stopping what it is doing. Here
+ * it takes over the per-conversion scale/filter/threshold work that would
+ * otherwise be an ADC ISR. Link with 28069_RAM_CLA_lnk.cmd instead of
+ * 28069_RAM_lnk.cmd; it gives L3 to the CLA for code, L1-L2 for its data,
+ * and places the two message RAMs:
+ *
+ * CpuToCla1MsgRAM  0x1500  written by the CPU, read by the CLA  (xclain)
+ * Cla1ToCpuMsgRAM  0x1480  written by the CLA, read by the CPU  (xclaout)
+ *
+ * Example: three currents on socs 0-2, converted on ePWM1 SOCA, with task 1
+ * (and so ADCINT1) following soc2:
+ *
+ * ClaInit();
+ * ClaAdcChannel(0, 0.0048, -9.94, 0.25, -20, 20);//A per count, A, alpha, A, A
+ * ClaAdcChannel(1, 0.0048, -9.94, 0.25, -20, 20);
+ * ClaAdcChannel(2, 0.0048, -9.94, 0.25, -20, 20);
+ * ClaAdcInit(1, 2);
+ * ...
+ * if (xclaout.latched) {//open the contactor}
+ *
+ * The math itself lives in cla_shared.h as macros, so it can be compiled and
+ * exercised on a PC; cla_host.c wraps it for that.
+ *
+ * Running from flash, Cla1Prog has to be copied from its load address to L3
+ * (as ramfuncs is) before ClaInit.
+ */
+#include "F2806x_Device.h"
+#include "cla.h"
+
+#pragma DATA_SECTION(xclain, "CpuToCla1MsgRAM")
+CLAADCIN xclain;
+#pragma DATA_SECTION(xclaout, "Cla1ToCpuMsgRAM")
+CLAADCOUT xclaout;
+
+/**
+ * Turn on the CLA's clock and give it its memory. No task will run until
+ * it is registered with ClaRegisterTask.
+ */
+void ClaInit() {
+	EALLOW;
+	SysCtrlRegs.PCLKCR3.bit.CLA1ENCLK = 1;
+	Cla1Regs.MIER.all = 0;
+	Cla1Regs.MPISRCSEL1.all = 0x11111111;//no peripheral triggers any task
+	Cla1Regs.MMEMCFG.bit.PROGE = 1;//L3 becomes CLA program memory
+	Cla1Regs.MMEMCFG.bit.RAM0E = 1;//L1 becomes CLA data memory, for its scratchpad
+	Cla1Regs.MMEMCFG.bit.RAM1E = 1;//and L2
+	EDIS;
+}
+
+/**
+ * Point a task at a function in cla_tasks.cla and say what starts it.
+ * When it finishes, the CLA throws CLA1INTn (n = task), which can be hooked
+ * with IsrInit from the Interrupts Library if the CPU wants to know.
+ *
+ * @param task 1-8
+ * @param fn The task, e.g. ClaAdcTask
+ * @param trig What sets it off
+ */
+void ClaRegisterTask(Uint16 task, __interrupt void (*fn)(void), CLATRIGGER trig) {
+	Uint16 shift = (task - 1) << 2;//four bits of MPISRCSEL1 per task
+
+	if (task < 1 || task > 8) {
+		return;
+	}
+	EALLOW;
+	(&Cla1Regs.MVECT1)[task - 1] = (Uint16)((Uint32)fn - (Uint32)&Cla1Prog_Start);//offset into L3
+	Cla1Regs.MPISRCSEL1.all = (Cla1Regs.MPISRCSEL1.all & ~(0xFUL << shift))
+			| ((Uint32)trig << shift);
+	Cla1Regs.MIER.all |= 1 << (task - 1);
+	EDIS;
+}
+
+/**
+ * Start a task from software, whatever its trigger.
+ *
+ * @param task 1-8
+ */
+void ClaForceTask(Uint16 task) {
+	EALLOW;//MIFRC is protected: without this the force is ignored
+	Cla1Regs.MIFRC.all = 1 << (task - 1);
+	EDIS;
+}
+
+/**
+ * @param task 1-8
+ * @return Nonzero while the task is pending or running
+ */
+Uint16 ClaTaskRunning(Uint16 task) {
+	return (Cla1Regs.MIFR.all | Cla1Regs.MIRUN.all) & (1 << (task - 1));
+}
+
+/**
+ * Hand socs 0 through last to the CLA. The task runs on ADCINT<task>, which
+ * this sets to follow last; set the channels up with ClaAdcChannel first.
+ * Nobody acknowledges the interrupt, so it is put in continuous mode; don't
+ * also register it with the PIE unless you clear its flag there.
+ *
+ * @param task 1-7; task 8 listens to ADCINT4 instead, so avoid it
+ * @param last The last soc to process, at most CLA_ADC_CHANNELS-1
+ */
+void ClaAdcInit(Uint16 task, Uint16 last) {
+	Uint16 n = task - 1;
+	Uint16 shift = (n & 1) << 3;//same layout AdcEnableIsr uses
+	volatile Uint16* intsel = &AdcRegs.INTSEL1N2.all + (n >> 1);
+
+	xclain.n = last + 1;
+
+	ClaRegisterTask(8, &ClaAdcReset, CLANONE);//zero the outputs, which only the CLA can do
+	ClaForceTask(8);
+	while (ClaTaskRunning(8));
+
+	EALLOW;
+	*intsel = (*intsel & ~(0x7F << shift)) | ((0x60 | last) << shift);//CONT, E, and the soc
+	EDIS;
+	ClaRegisterTask(task, &ClaAdcTask, CLAADC);
+}
+
+/**
+ * value = raw*gain + offset, low-passed with alpha, tripping outside [lo, hi].
+ *
+ * @param soc 0 to CLA_ADC_CHANNELS-1
+ * @param gain Engineering units per count
+ * @param offset Engineering units at a count of 0
+ * @param alpha Filter coefficient, 0 < alpha <= 1; the time constant is
+ * 				about 1/alpha samples
+ * @param lo Lowest acceptable value
+ * @param hi Highest acceptable value
+ */
+void ClaAdcChannel(Uint16 soc, float32 gain, float32 offset, float32 alpha, float32 lo, float32 hi) {
+	if (soc >= CLA_ADC_CHANNELS) {
+		return;
+	}
+	xclain.gain[soc] = gain;
+	xclain.offset[soc] = offset;
+	xclain.alpha[soc] = alpha;
+	xclain.lo[soc] = lo;
+	xclain.hi[soc] = hi;
+}
+
+/**
+ * Ask the CLA to forget latched trips. Takes effect on its next run, when
+ * xclaout.cleared catches up with xclain.clear.
+ */
+void ClaAdcClear() {
+	xclain.clear++;
+}
@@ -0,0 +1,35 @@
+/**
+ * Setting up the Control Law Accelerator from the CPU side, and sharing
+ * data with it. See cla.c.
+ */
+#ifndef CLA_H_
+#define CLA_H_
+
+#include "cla_shared.h"
+
+/**
+ * What sets off a task. Task n (1-8) can listen to ADCINTn or to the
+ * ePWMn interrupt (task 8: CPU timer 0 instead), or only be forced from
+ * software.
+ */
+typedef enum {
+	CLAADC = 0,		CLANONE = 1,	CLAPERIPH = 2
+} CLATRIGGER;
+
+extern CLAADCIN xclain;//CPU -> CLA message RAM
+extern CLAADCOUT xclaout;//CLA -> CPU message RAM
+
+extern Uint16 Cla1Prog_Start;//from the linker command file
+extern __interrupt void ClaAdcTask(void);//from cla_tasks.cla
+extern __interrupt void ClaAdcReset(void);
+
+void ClaInit(void);
+void ClaRegisterTask(Uint16, __interrupt void (*)(void), CLATRIGGER);
+void ClaForceTask(Uint16);
+Uint16 ClaTaskRunning(Uint16);
+
+void ClaAdcInit(Uint16, Uint16);
+void ClaAdcChannel(Uint16, float32, float32, float32, float32, float32);
+void ClaAdcClear(void);
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * @file cla_host.c
+ * @brief The CLA tasks as ordinary functions, for building on a PC
+ * @ingroup Digital
+ * @version 0
+ *
+ * http://solarracing.gatech.edu/wiki/Main_Page
+ * Not part of the target build. Compile this with any C compiler alongside
+ * your own main to feed the ADC task made-up samples and check what comes
+ * out, e.g.
+ *
+ * gcc -I"System Libraries/CLA Library" cla_host.c mytest.c
+ *
+ * It expands the same macros cla_tasks.cla does, so what passes here is
+ * what the CLA runs. The CLA does its float math in single precision like
+ * this does, but rounds a little differently, so compare with a tolerance.
+ */
+#include "cla_shared.h"
+
+/**
+ * @param in The settings the CPU would have put in CpuToCla1MsgRAM
+ * @param out Stands in for Cla1ToCpuMsgRAM
+ * @param raw Fake result registers, in->n of them
+ */
+void ClaAdcTaskHost(const CLAADCIN* in, CLAADCOUT* out, const unsigned short* raw) {
+	CLA_ADC_STEP(*in, *out, raw);
+}
+
+/**
+ * @param in The settings the CPU would have put in CpuToCla1MsgRAM
+ * @param out Stands in for Cla1ToCpuMsgRAM
+ */
+void ClaAdcResetHost(const CLAADCIN* in, CLAADCOUT* out) {
+	CLA_ADC_RESET(*in, *out);
+}
@@ -0,0 +1,85 @@
+/**
+ * What the CPU and the CLA agree on: the layout of the two message RAMs and
+ * the per-sample math of the ADC task. The C28x compiler, the CLA compiler
+ * and a plain host gcc all read this file, so it stays plain C:
+ *  - no F2806x_Device.h. Its Uint16 is an int, which the CLA compiler makes
+ *    32 bits wide, so the structs below spell out short/long instead.
+ *  - the task math is a macro rather than a function, because CLA C on the
+ *    F28069 cannot make calls.
+ */
+#ifndef CLA_SHARED_H_
+#define CLA_SHARED_H_
+
+#define CLA_ADC_CHANNELS 8//socs 0-7; more won't fit the 128-word message RAM
+
+/**
+ * CPU -> CLA, in CpuToCla1MsgRAM (the CLA can only read it). For each soc i
+ * below n the ADC task computes
+ *
+ * x = raw*gain[i] + offset[i]
+ * value[i] += alpha[i]*(x - value[i])
+ *
+ * (a one-pole low-pass; alpha = 1 means no filtering) and trips channel i
+ * when value[i] leaves [lo[i], hi[i]].
+ */
+typedef struct {
+	float gain[CLA_ADC_CHANNELS];
+	float offset[CLA_ADC_CHANNELS];
+	float alpha[CLA_ADC_CHANNELS];
+	float lo[CLA_ADC_CHANNELS];
+	float hi[CLA_ADC_CHANNELS];
+	unsigned short n;//number of socs to process, starting at soc0
+	unsigned short clear;//bump this to ask the CLA to clear latched
+} CLAADCIN;
+
+/**
+ * CLA -> CPU, in Cla1ToCpuMsgRAM (the CPU can only read it). Since the CPU
+ * cannot clear latched itself, it bumps CLAADCIN.clear and the CLA clears it
+ * on its next run, copying clear into cleared to say it has done so.
+ */
+typedef struct {
+	float value[CLA_ADC_CHANNELS];//scaled and filtered
+	unsigned short trips;//bit i set if soc i was out of range on the last sample
+	unsigned short latched;//bit i set if soc i has been out of range since the last clear
+	unsigned short cleared;
+	unsigned long count;//samples processed
+} CLAADCOUT;
+
+/**
+ * One run of the ADC task. in and out are the structs above, raw points at
+ * the first result register (or, off-target, at an array of fake results).
+ */
+#define CLA_ADC_STEP(in, out, raw) do {										\
+	unsigned short i_, bit_ = 1, trips_ = 0;								\
+	if ((in).clear != (out).cleared) {										\
+		(out).latched = 0;													\
+		(out).cleared = (in).clear;											\
+	}																		\
+	for (i_ = 0; i_ < (in).n; i_++, bit_ <<= 1) {							\
+		float x_ = (float)(raw)[i_]*(in).gain[i_] + (in).offset[i_];		\
+		float y_ = (out).value[i_] + (in).alpha[i_]*(x_ - (out).value[i_]);	\
+		(out).value[i_] = y_;												\
+		if (y_ > (in).hi[i_] || y_ < (in).lo[i_]) {							\
+			trips_ |= bit_;													\
+		}																	\
+	}																		\
+	(out).trips = trips_;													\
+	(out).latched |= trips_;												\
+	(out).count++;															\
+} while (0)
+
+/**
+ * Start the filters from zero and forget any trips.
+ */
+#define CLA_ADC_RESET(in, out) do {											\
+	unsigned short i_;														\
+	for (i_ = 0; i_ < CLA_ADC_CHANNELS; i_++) {								\
+		(out).value[i_] = 0;												\
+	}																		\
+	(out).trips = 0;														\
+	(out).latched = 0;														\
+	(out).cleared = (in).clear;												\
+	(out).count = 0;														\
+} while (0)
+
+#endif
@@ -1,5 +1,5 @@
-/**
- * @author Pavel Komarov <pkomarov@gatech.edu> 941-545-7573
- */
-
-void InitFlash(void);
+/**
+ * @author Pavel Komarov <pkomarov@gatech.edu> 941-545-7573
+ */
+
+void InitFlash(void);
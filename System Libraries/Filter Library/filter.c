@@ -0,0 +1,141 @@
+/**
+ * @file filter.c
+ * @brief A library that runs FIR filters over blocks of ADC samples
+ * @ingroup Digital
+ * @version 0
+ *
+ * http://solarracing.gatech.edu/wiki/Main_Page
+ * TI ships 32-tap low-pass designs in 28069Common/h/fdacoefs.h (float) and
+ * fdacoefs_fixed.h (Q31). Pull one in by name in exactly one file of your
+ * project (those headers define tables, so including them twice won't link):
+ *
+ * #include "fdacoefs.h"
+ * const float32 lpf[32] = FPU_LPF32_01K_11K;
+ *
+ * Then give each channel a FIRF (or FIRQ15) and a delay line, and hand it
+ * whole blocks of samples, e.g. a half-buffer from AdcStreamReady in the ADC
+ * Library. Samples in such a block are interleaved by soc, so the stride
+ * argument says how far apart one channel's samples are.
+ *
+ * The delay lines are circular, but stored twice over (2*ntaps long): each
+ * sample is written at pos and pos+ntaps, so the newest ntaps samples are
+ * always contiguous starting at pos and the inner loop never has to wrap.
+ *
+ * Use the float path on the F28069, which has an FPU; the Q15 path is for
+ * parts without one, or when every cycle matters.
+ */
+#include "F2806x_Device.h"
+#include "filter.h"
+
+/**
+ * @param f The FIRF to set up
+ * @param coefs ntaps coefficients, e.g. one of the FPU_LPF32 sets
+ * @param ntaps The number of coefficients
+ * @param delay A buffer of 2*ntaps float32s for this channel alone
+ */
+void FirInitF(FIRF* f, const float32* coefs, Uint16 ntaps, float32* delay) {
+	Uint16 i;
+	f->coefs = coefs;
+	f->ntaps = ntaps;
+	f->delay = delay;
+	f->pos = 0;
+	for (i = 0; i < 2*ntaps; i++) {
+		delay[i] = 0;
+	}
+}
+
+/**
+ * Filter a block of samples.
+ *
+ * @param f A channel set up with FirInitF
+ * @param in The first of this channel's samples, in ADC counts
+ * @param stride The distance between consecutive samples of this channel in
+ * 				in (1 for a plain array, the number of socs for a stream block)
+ * @param out An array of len outputs, in ADC counts
+ * @param len The number of samples to filter
+ */
+void FirBlockF(FIRF* f, const Uint16* in, Uint16 stride, float32* out, Uint16 len) {
+	const float32* c = f->coefs;
+	float32* d;
+	float32 acc;
+	Uint16 n = f->ntaps;
+	Uint16 pos = f->pos;
+	Uint16 i, k;
+
+	for (i = 0; i < len; i++) {
+		pos = (pos == 0) ? n - 1 : pos - 1;//walk backward so d[k] is k samples old
+		d = f->delay + pos;
+		d[0] = d[n] = in[i*stride];
+
+		acc = 0;
+		for (k = 0; k < n; k++) {
+			acc += c[k]*d[k];
+		}
+		out[i] = acc;
+	}
+	f->pos = pos;
+}
+
+/**
+ * Convert a set of Q31 coefficients (fdacoefs_fixed.h) to Q15, rounding.
+ * Do this once at init.
+ *
+ * @param q31 ntaps coefficients in Q31, e.g. one of the FIX_LPF32 sets
+ * @param q15 Where to put ntaps coefficients in Q15
+ * @param ntaps The number of coefficients
+ */
+void FirCoefsQ15(const int32* q31, int16* q15, Uint16 ntaps) {
+	Uint16 i;
+	for (i = 0; i < ntaps; i++) {
+		q15[i] = (int16)((q31[i] + 0x8000L) >> 16);
+	}
+}
+
+/**
+ * @param f The FIRQ15 to set up
+ * @param coefs ntaps coefficients in Q15
+ * @param ntaps The number of coefficients
+ * @param delay A buffer of 2*ntaps int16s for this channel alone
+ */
+void FirInitQ15(FIRQ15* f, const int16* coefs, Uint16 ntaps, int16* delay) {
+	Uint16 i;
+	f->coefs = coefs;
+	f->ntaps = ntaps;
+	f->delay = delay;
+	f->pos = 0;
+	for (i = 0; i < 2*ntaps; i++) {
+		delay[i] = 0;
+	}
+}
+
+/**
+ * Filter a block of samples in fixed point. The accumulator is 32 bits, which
+ * is plenty for 12-bit samples through a low-pass with unity DC gain.
+ *
+ * @param f A channel set up with FirInitQ15
+ * @param in The first of this channel's samples, in ADC counts
+ * @param stride The distance between consecutive samples of this channel in in
+ * @param out An array of len outputs, in ADC counts
+ * @param len The number of samples to filter
+ */
+void FirBlockQ15(FIRQ15* f, const Uint16* in, Uint16 stride, int16* out, Uint16 len) {
+	const int16* c = f->coefs;
+	int16* d;
+	int32 acc;
+	Uint16 n = f->ntaps;
+	Uint16 pos = f->pos;
+	Uint16 i, k;
+
+	for (i = 0; i < len; i++) {
+		pos = (pos == 0) ? n - 1 : pos - 1;
+		d = f->delay + pos;
+		d[0] = d[n] = (int16)in[i*stride];
+
+		acc = 0x4000;//half an LSB, to round
+		for (k = 0; k < n; k++) {
+			acc += (int32)c[k]*d[k];
+		}
+		out[i] = (int16)(acc >> 15);
+	}
+	f->pos = pos;
+}
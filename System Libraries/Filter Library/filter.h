@@ -0,0 +1,36 @@
+/**
+ * Block FIR filters over the coefficient sets in fdacoefs.h (float) and
+ * fdacoefs_fixed.h (Q31, converted once to Q15 with FirCoefsQ15).
+ */
+#ifndef FILTER_H_
+#define FILTER_H_
+
+/**
+ * One channel's worth of float FIR. Several channels can point at the same
+ * coefs; each needs its own delay line of 2*ntaps words.
+ */
+typedef struct {
+	const float32* coefs;
+	Uint16 ntaps;
+	float32* delay;
+	Uint16 pos;
+} FIRF;
+
+/**
+ * The same, in Q15.
+ */
+typedef struct {
+	const int16* coefs;
+	Uint16 ntaps;
+	int16* delay;
+	Uint16 pos;
+} FIRQ15;
+
+void FirInitF(FIRF*, const float32*, Uint16, float32*);
+void FirBlockF(FIRF*, const Uint16*, Uint16, float32*, Uint16);
+
+void FirCoefsQ15(const int32*, int16*, Uint16);
+void FirInitQ15(FIRQ15*, const int16*, Uint16, int16*);
+void FirBlockQ15(FIRQ15*, const Uint16*, Uint16, int16*, Uint16);
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file filter_host.c
+ * @brief Times the FIR filters on a PC
+ * @ingroup Digital
+ * @version 0
+ *
+ * http://solarracing.gatech.edu/wiki/Main_Page
+ * Not part of the target build. Runs FirBlockF and FirBlockQ15 over blocks of
+ * made-up ADC samples, three channels interleaved as AdcStream hands them
+ * over, checks the two agree, and reports samples/s per channel for each, e.g.
+ *
+ * gcc -O2 -I28069Common/h "System Libraries/Filter Library/filter_host.c" -o firbench
+ *
+ * The C28x widths are pinned before filter.c is pulled in, so the Q15 path
+ * overflows (or doesn't) as it would on the chip. The numbers are the PC's:
+ * use them to compare the two paths and changes to them, not to budget the
+ * F28069.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#define F2806x_DEVICE_H//keep the register definitions out: only the types are wanted
+typedef int16_t int16;
+typedef int32_t int32;
+typedef uint16_t Uint16;
+typedef uint32_t Uint32;
+typedef float float32;
+#include "fdacoefs.h"
+#include "fdacoefs_fixed.h"
+#include "filter.c"
+
+#define CHANNELS 3//socs per block, as in adcstreamtest
+#define BLOCK 64//samples per channel per block
+#define BLOCKS 20000//blocks timed per path
+#define NTAPS 32
+
+static const float32 xcoefs[NTAPS] = FPU_LPF32_01K_11K;
+static const int32 xcoefsq31[NTAPS] = FIX_LPF32_01K_11K;
+
+/**
+ * @return Samples/s per channel, with every channel of in being filtered
+ */
+static double timeFloat(const Uint16* in, float32* out) {
+	FIRF f[CHANNELS];
+	float32 delay[CHANNELS][2*NTAPS];
+	clock_t start;
+	Uint16 b, ch;
+
+	for (ch = 0; ch < CHANNELS; ch++) {
+		FirInitF(&f[ch], xcoefs, NTAPS, delay[ch]);
+	}
+	start = clock();
+	for (b = 0; b < BLOCKS; b++) {
+		for (ch = 0; ch < CHANNELS; ch++) {
+			FirBlockF(&f[ch], in + ch, CHANNELS, out + ch*BLOCK, BLOCK);
+		}
+	}
+	return (double)BLOCKS*BLOCK/((double)(clock() - start)/CLOCKS_PER_SEC);
+}
+
+static double timeQ15(const Uint16* in, int16* out) {
+	FIRQ15 f[CHANNELS];
+	int16 coefs[NTAPS];
+	int16 delay[CHANNELS][2*NTAPS];
+	clock_t start;
+	Uint16 b, ch;
+
+	FirCoefsQ15(xcoefsq31, coefs, NTAPS);
+	for (ch = 0; ch < CHANNELS; ch++) {
+		FirInitQ15(&f[ch], coefs, NTAPS, delay[ch]);
+	}
+	start = clock();
+	for (b = 0; b < BLOCKS; b++) {
+		for (ch = 0; ch < CHANNELS; ch++) {
+			FirBlockQ15(&f[ch], in + ch, CHANNELS, out + ch*BLOCK, BLOCK);
+		}
+	}
+	return (double)BLOCKS*BLOCK/((double)(clock() - start)/CLOCKS_PER_SEC);
+}
+
+int main(void) {
+	Uint16 in[CHANNELS*BLOCK];
+	float32 outf[CHANNELS*BLOCK];
+	int16 outq[CHANNELS*BLOCK];
+	double ratef, rateq, diff, worst = 0;
+	Uint16 i;
+
+	for (i = 0; i < CHANNELS*BLOCK; i++) {//a slow triangle per channel, with some noise
+		in[i] = 2048 + ((i/CHANNELS*37) % 1600) - 800 + ((i*7919) % 41) + (i % CHANNELS)*100;
+	}
+	ratef = timeFloat(in, outf);
+	rateq = timeQ15(in, outq);
+
+	for (i = 0; i < CHANNELS*BLOCK; i++) {//both filters have run BLOCKS times over the same input
+		diff = outf[i] - outq[i];
+		if (diff < 0) {
+			diff = -diff;
+		}
+		if (diff > worst) {
+			worst = diff;
+		}
+	}
+
+	printf("%d taps, %d channels, blocks of %d\n", NTAPS, CHANNELS, BLOCK);
+	printf("float: %.3g samples/s per channel\n", ratef);
+	printf("Q15:   %.3g samples/s per channel\n", rateq);
+	printf("largest float/Q15 difference: %.2f counts\n", worst);
+	if (worst > 2) {
+		printf("FAILED: the paths disagree\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,361 @@
+/**
+ * @file packet.c
+ * @brief Binary packets over SCI: COBS framing and a CRC-16
+ * @ingroup Digital
+ *
+ * See packet.h for what goes on the wire.
+ *
+ * Sending:
+ *
+ * PACKET p;
+ * PacketInit(&p, 3);
+ * PacketPutFloat(&p, volts);
+ * PacketPutUint16(&p, count);
+ * PacketSend(SCIA, &p);
+ *
+ * Receiving, decoded by the RX interrupt as it comes in:
+ *
+ * PACKETRX rx;
+ * PACKET p;
+ * EnableSciInterrupts(SCIA);
+ * PacketRxInit(SCIA, &rx);
+ * IsrInit(SCIARX, &SciaRxIsr);
+ * while(1) {
+ *     if (PacketReceive(&rx, &p) && p.type == 3) {
+ *         volts = PacketGetFloat(&p, 0);
+ *         count = PacketGetUint16(&p, 4);
+ *     }
+ * }
+ */
+#include "F2806x_Device.h"
+#include "packet.h"
+#include "string.h"
+
+/**
+ * CRC-16/CCITT-FALSE of every byte value, so the CRC costs a lookup a byte
+ * rather than a loop over its bits.
+ */
+static const Uint16 xcrctable[256] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+static char xframe[PACKET_FRAME];//PacketSend encodes into this
+
+/**
+ * Start an empty packet.
+ *
+ * @param packet The packet
+ * @param type What the packet holds, 0-255
+ */
+void PacketInit(PACKET* packet, Uint16 type) {
+	packet->type = type & 0xFF;
+	packet->length = 0;
+}
+
+/**
+ * Append bytes least significant first.
+ *
+ * @return 1, or 0 if they didn't fit and nothing was added
+ */
+static Uint16 packetPut(PACKET* packet, Uint32 value, Uint16 bytes) {
+	Uint16 i;
+
+	if (packet->length + bytes > PACKET_MAX) {
+		return 0;
+	}
+	for (i = 0; i < bytes; i++) {
+		packet->data[packet->length++] = value & 0xFF;
+		value >>= 8;
+	}
+	return 1;
+}
+
+/**
+ * Read bytes stored least significant first. Reading past the end gives 0s.
+ */
+static Uint32 packetGet(PACKET* packet, Uint16 offset, Uint16 bytes) {
+	Uint32 value = 0;
+
+	while (bytes--) {
+		value <<= 8;
+		if (offset + bytes < packet->length) {
+			value |= packet->data[offset + bytes] & 0xFF;
+		}
+	}
+	return value;
+}
+
+/**
+ * Append a 16-bit value (signed values go in as they are and come back out of
+ * a cast).
+ *
+ * @param packet The packet
+ * @param value The value
+ * @return 1, or 0 if the packet was full and nothing was added
+ */
+Uint16 PacketPutUint16(PACKET* packet, Uint16 value) {
+	return packetPut(packet, value, 2);
+}
+
+/**
+ * Append a 32-bit value.
+ *
+ * @param packet The packet
+ * @param value The value
+ * @return 1, or 0 if the packet was full and nothing was added
+ */
+Uint16 PacketPutUint32(PACKET* packet, Uint32 value) {
+	return packetPut(packet, value, 4);
+}
+
+/**
+ * Append an IEEE 754 single, as 4 bytes.
+ *
+ * @param packet The packet
+ * @param value The value
+ * @return 1, or 0 if the packet was full and nothing was added
+ */
+Uint16 PacketPutFloat(PACKET* packet, float32 value) {
+	union { float32 f; Uint32 u; } bits;
+
+	bits.u = 0;
+	bits.f = value;
+	return packetPut(packet, bits.u, 4);
+}
+
+/**
+ * @param packet The packet
+ * @param offset Where in its data the value starts
+ * @return The 16-bit value there
+ */
+Uint16 PacketGetUint16(PACKET* packet, Uint16 offset) {
+	return packetGet(packet, offset, 2);
+}
+
+/**
+ * @param packet The packet
+ * @param offset Where in its data the value starts
+ * @return The 32-bit value there
+ */
+Uint32 PacketGetUint32(PACKET* packet, Uint16 offset) {
+	return packetGet(packet, offset, 4);
+}
+
+/**
+ * @param packet The packet
+ * @param offset Where in its data the value starts
+ * @return The single there
+ */
+float32 PacketGetFloat(PACKET* packet, Uint16 offset) {
+	union { float32 f; Uint32 u; } bits;
+
+	bits.u = packetGet(packet, offset, 4);
+	return bits.f;
+}
+
+/**
+ * Run bytes through CRC-16/CCITT-FALSE. Start with crc = 0xFFFF; to CRC
+ * something in pieces, pass each piece the result of the last.
+ *
+ * @param crc 0xFFFF, or the CRC so far
+ * @param bytes The bytes, one to a char
+ * @param length How many
+ * @return The CRC
+ */
+Uint16 PacketCrc16(Uint16 crc, char* bytes, Uint16 length) {
+	Uint16 i;
+
+	for (i = 0; i < length; i++) {
+		crc = ((crc << 8) ^ xcrctable[((crc >> 8) ^ bytes[i]) & 0xFF]) & 0xFFFF;
+	}
+	return crc;
+}
+
+/**
+ * Encode a packet as it goes on the wire.
+ *
+ * @param packet The packet
+ * @param frame Room for PACKET_FRAME bytes
+ * @return How many bytes of frame were used, ending with the 0x00
+ */
+Uint16 PacketEncode(PACKET* packet, char* frame) {
+	char head[1];
+	char tail[2];
+	Uint16 crc, i, n, code, length, byte;
+
+	head[0] = packet->type & 0xFF;
+	crc = PacketCrc16(0xFFFF, head, 1);
+	crc = PacketCrc16(crc, packet->data, packet->length);
+	tail[0] = crc & 0xFF;
+	tail[1] = crc >> 8;
+
+	//COBS: each run of up to 254 non-zero bytes is preceded by its length + 1;
+	//a code under 0xFF means a 0x00 followed the run
+	length = packet->length + 3;
+	code = 0;//where the code for the current run goes
+	n = 1;
+	for (i = 0; i < length; i++) {
+		if (i == 0) {
+			byte = head[0];
+		} else if (i <= packet->length) {
+			byte = packet->data[i - 1] & 0xFF;
+		} else {
+			byte = tail[i - packet->length - 1];
+		}
+		if (byte != 0) {
+			frame[n++] = byte;
+		}
+		if (byte == 0 || n - code == 0xFF) {
+			frame[code] = n - code;
+			code = n++;
+		}
+	}
+	frame[code] = n - code;
+	frame[n++] = 0;
+	return n;
+}
+
+/**
+ * Send a packet. Blocks as sendCharArray does; not for use from an ISR while
+ * the main loop might be sending too.
+ *
+ * @param port The port, as returned by SciInit
+ * @param packet The packet
+ * @return 1 if sent (or queued), 0 if the port's buffer was too full and
+ * 				nothing was sent
+ */
+Uint16 PacketSend(SCIPORT* port, PACKET* packet) {
+	return sendCharArray(port, xframe, PacketEncode(packet, xframe));
+}
+
+/**
+ * Decode packets from a port as they arrive. Call after EnableSciInterrupts:
+ * from then on the port's RX interrupt gives every byte to rx, and SciRead
+ * and recieveChar get nothing.
+ *
+ * @param port The port, as returned by SciInit
+ * @param rx Decoder state, which must stay put while it is in use
+ */
+void PacketRxInit(SCIPORT* port, PACKETRX* rx) {
+	memset(rx, 0, sizeof(PACKETRX));
+	rx->code = 0xFF;//no 0x00 goes in ahead of the first run
+	port->rxhookarg = rx;
+	port->rxhook = &PacketRxByte;
+}
+
+/**
+ * The end of a frame: keep the packet if it checks out.
+ */
+static void packetRxEnd(PACKETRX* rx) {
+	Uint16 crc;
+
+	if (rx->n == 0 && rx->left == 0 && !rx->overflow) {
+		return;//two 0x00s in a row: nothing lost
+	}
+	if (rx->overflow || rx->left != 0 || rx->n < 3) {
+		rx->errors++;
+		return;
+	}
+	crc = PacketCrc16(0xFFFF, rx->buf, rx->n - 2);
+	if ((rx->buf[rx->n - 2] & 0xFF) != (crc & 0xFF)
+			|| (rx->buf[rx->n - 1] & 0xFF) != (crc >> 8)) {
+		rx->crcerrors++;
+		return;
+	}
+	rx->packets++;
+	if (rx->full) {
+		rx->dropped++;
+		return;
+	}
+	rx->ready.type = rx->buf[0] & 0xFF;
+	rx->ready.length = rx->n - 3;
+	memcpy(rx->ready.data, &rx->buf[1], rx->ready.length);
+	rx->full = 1;//only now can PacketReceive see it
+}
+
+/**
+ * Take one received byte. PacketRxInit arranges for the RX interrupt to call
+ * this; it could also be fed by hand.
+ *
+ * @param arg The PACKETRX, as a void* to fit SCIPORT's rxhook
+ * @param byte The byte
+ */
+void PacketRxByte(void* arg, Uint16 byte) {
+	PACKETRX* rx = arg;
+	Uint16 zero;
+
+	byte &= 0xFF;
+	if (byte == 0) {
+		packetRxEnd(rx);
+		rx->n = 0;
+		rx->left = 0;
+		rx->code = 0xFF;
+		rx->overflow = 0;
+		return;
+	}
+	if (rx->left == 0) {//a COBS code: the 0x00 that ended the last run goes in
+		zero = (rx->code != 0xFF);//unless the run was cut at 254 bytes
+		rx->code = byte;
+		rx->left = byte - 1;
+		if (!zero) {
+			return;
+		}
+		byte = 0;
+	} else {
+		rx->left--;
+	}
+	if (rx->n >= sizeof(rx->buf)) {
+		rx->overflow = 1;
+	} else {
+		rx->buf[rx->n++] = byte;
+	}
+}
+
+/**
+ * Take the packet waiting, if there is one. Call from the main loop.
+ *
+ * @param rx The decoder given to PacketRxInit
+ * @param packet Where to copy the packet
+ * @return 1 if there was a packet, 0 if not
+ */
+Uint16 PacketReceive(PACKETRX* rx, PACKET* packet) {
+	if (!rx->full) {
+		return 0;
+	}
+	packet->type = rx->ready.type;
+	packet->length = rx->ready.length;
+	memcpy(packet->data, rx->ready.data, packet->length);
+	rx->full = 0;//only now can the interrupt reuse it
+	return 1;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file packet.h
+ * @brief Binary packets over SCI: COBS framing and a CRC-16
+ *
+ * On the wire a packet is
+ *     COBS( type, data..., crc low, crc high ) 0x00
+ * where the CRC is CRC-16/CCITT-FALSE (polynomial 0x1021, starting at 0xFFFF)
+ * of the type and data. COBS takes every 0x00 out of what it encodes, so the
+ * 0x00 that ends a packet can only be the end of one: a receiver that starts
+ * half way through a packet, or loses a byte, is back in step at the next 0x00.
+ * It costs one byte in 254, plus the 0x00 and the first COBS code.
+ *
+ * Data is bytes, one to a char, and multi-byte values are little-endian; use
+ * the PacketPut and PacketGet functions rather than copying structs, which the
+ * C28x lays out in 16-bit words. packet.py is the same thing for a PC.
+ */
+#ifndef PACKET_H_
+#define PACKET_H_
+
+#include "sci.h"
+
+#define PACKET_MAX 64//most data bytes in a packet
+#define PACKET_FRAME (PACKET_MAX + 3 + (PACKET_MAX + 3)/254 + 2)//most bytes on the wire
+
+typedef struct {
+	Uint16 type;//what the data is: up to whoever is on each end
+	Uint16 length;//data bytes
+	char data[PACKET_MAX];
+} PACKET;
+
+/*
+ * The receiving end of a port, run by the SCI RX interrupt once PacketRxInit
+ * has hooked it in. It decodes as the bytes arrive, and a packet that checks
+ * out waits in ready for PacketReceive. If one arrives before the last was
+ * taken it is dropped.
+ */
+typedef struct {
+	char buf[PACKET_MAX + 3];//type, data and CRC, decoded so far
+	Uint16 n;//bytes in buf
+	Uint16 left;//bytes to go before the next COBS code, 0 if the next byte is one
+	Uint16 code;//the last COBS code
+	Uint16 overflow;//set if this packet would not fit; it is thrown away at the 0x00
+	PACKET ready;
+	volatile Uint16 full;//ready holds a packet not yet taken
+	Uint32 packets;//good packets received
+	Uint32 crcerrors;//packets thrown away because their CRC was wrong
+	Uint32 errors;//packets too short, too long, or cut off
+	Uint32 dropped;//good packets lost because ready was still full
+} PACKETRX;
+
+void PacketInit(PACKET* packet, Uint16 type);
+Uint16 PacketPutUint16(PACKET* packet, Uint16 value);
+Uint16 PacketPutUint32(PACKET* packet, Uint32 value);
+Uint16 PacketPutFloat(PACKET* packet, float32 value);
+Uint16 PacketGetUint16(PACKET* packet, Uint16 offset);
+Uint32 PacketGetUint32(PACKET* packet, Uint16 offset);
+float32 PacketGetFloat(PACKET* packet, Uint16 offset);
+
+Uint16 PacketCrc16(Uint16 crc, char* bytes, Uint16 length);
+Uint16 PacketEncode(PACKET* packet, char* frame);
+Uint16 PacketSend(SCIPORT* port, PACKET* packet);
+
+void PacketRxInit(SCIPORT* port, PACKETRX* rx);
+void PacketRxByte(void* rx, Uint16 byte);
+Uint16 PacketReceive(PACKETRX* rx, PACKET* packet);
+
+#endif /* PACKET_H_ */
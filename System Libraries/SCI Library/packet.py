@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""
+The PC end of packet.c: COBS-framed packets with a CRC-16 (see packet.h).
+
+    python3 packet.py                  check encode and decode against each other
+    python3 packet.py capture.bin      print every packet in a capture
+    python3 packet.py --frame list     frame every packet in a listing, to stdout
+
+capture.bin is the raw bytes from the serial port, e.g.
+    stty -F /dev/ttyUSB0 115200 raw && cat /dev/ttyUSB0 > capture.bin
+Packets are printed one to a line as type,payload in hex; --frame reads the
+same format back, so a listing can be replayed to a board. packet_host.c uses
+both to check packet.c against this file.
+
+To talk to a board from a script, frame() a packet and write it; feed what
+comes back to a Decoder a chunk at a time.
+"""
+import random
+import struct
+import sys
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE, as PacketCrc16."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+        crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code = 0  # Where the code for the current run goes
+    for byte in data:
+        if byte:
+            out.append(byte)
+        if not byte or len(out) - code == 0xFF:
+            out[code] = len(out) - code
+            code = len(out)
+            out.append(0)
+    out[code] = len(out) - code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError('bad COBS')
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def frame(ptype, payload=b''):
+    """A packet as PacketEncode puts it on the wire, 0x00 and all."""
+    body = bytes([ptype]) + bytes(payload)
+    return cobs_encode(body + struct.pack('<H', crc16(body))) + b'\0'
+
+
+def unframe(data):
+    """(type, payload) from one frame, with or without its 0x00."""
+    body = cobs_decode(data.rstrip(b'\0'))
+    if len(body) < 3:
+        raise ValueError('short packet')
+    if crc16(body[:-2]) != struct.unpack('<H', body[-2:])[0]:
+        raise ValueError('bad CRC')
+    return body[0], body[1:-2]
+
+
+class Decoder:
+    """Splits a byte stream into packets, counting what it throws away."""
+
+    def __init__(self):
+        self.pending = bytearray()
+        self.packets = self.errors = 0
+
+    def feed(self, data):
+        """Returns every (type, payload) completed by data."""
+        found = []
+        for byte in data:
+            if byte:
+                self.pending.append(byte)
+                continue
+            if self.pending:
+                try:
+                    found.append(unframe(bytes(self.pending)))
+                    self.packets += 1
+                except ValueError:
+                    self.errors += 1
+            self.pending.clear()
+        return found
+
+
+def self_test():
+    rng = random.Random(1)
+    cases = [b'', b'\0', b'\0\0', bytes(range(1, 256)), bytes(253), bytes([0xFF]) * 600]
+    cases += [bytes(rng.choice((0, rng.randrange(256))) for _ in range(rng.randrange(80)))
+              for _ in range(500)]
+    for payload in cases:
+        ptype = rng.randrange(256)
+        wire = frame(ptype, payload)
+        assert b'\0' not in wire[:-1]
+        assert unframe(wire) == (ptype, payload)
+    assert crc16(b'123456789') == 0x29B1
+
+    # A stream with noise before it (which the 0x00 after ends) and a
+    # corrupted packet in it
+    dec = Decoder()
+    stream = b'\x13\x37\0' + frame(1, b'hi') + frame(2, b'\0\0') + frame(3, b'xyz')
+    bad = bytearray(stream)
+    bad[-3] ^= 0x40
+    got = []
+    for i in range(0, len(bad), 3):
+        got += dec.feed(bad[i:i + 3])
+    assert got == [(1, b'hi'), (2, b'\0\0')], got
+    assert dec.errors == 2  # The noise and the last packet
+    print('ok')
+
+
+def main():
+    if len(sys.argv) < 2:
+        self_test()
+        return
+    if sys.argv[1] == '--frame':
+        with open(sys.argv[2]) as f:
+            for line in f:
+                if line.strip():
+                    ptype, payload = line.strip().split(',')
+                    sys.stdout.buffer.write(frame(int(ptype), bytes.fromhex(payload)))
+        return
+    with open(sys.argv[1], 'rb') as f:
+        data = f.read()
+    dec = Decoder()
+    for ptype, payload in dec.feed(data):
+        print('%d,%s' % (ptype, payload.hex()))
+    sys.stderr.write('%d packets, %d thrown away\n' % (dec.packets, dec.errors))
+
+
+if __name__ == '__main__':
+    main()
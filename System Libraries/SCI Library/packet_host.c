@@ -0,0 +1,241 @@
+/**
+ * @file packet_host.c
+ * @brief packet.c against itself and against packet.py, on a PC
+ * @ingroup Digital
+ *
+ * Not part of the target build. Pushes random packets through PacketEncode
+ * and, a byte at a time as the RX interrupt would, PacketRxByte, with noise
+ * and corrupted frames mixed in, and checks every good packet comes out
+ * whole and every bad one is thrown away. Then it has packet.py decode what
+ * PacketEncode wrote, and decodes what packet.py framed, so the two ends
+ * can't drift apart. From the top of the tree:
+ *
+ * gcc -O2 -w -D__cregister= -Dinterrupt= -D__interrupt= -Dcregister=
+ * 		-D'asm(x)=' -D'__asm(x)=' -I28069Common/h -I"System Libraries/SCI Library"
+ * 		"System Libraries/SCI Library/packet_host.c" -o packets && ./packets
+ *
+ * Give the path to packet.py as an argument if running from elsewhere.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define DSP28_DATA_TYPES//pin the C28x widths before the device headers can
+#define _TI_STD_TYPES
+typedef int16_t int16;
+typedef int32_t int32;
+typedef long long int64;
+typedef unsigned long long Uint64;
+typedef float float32;
+typedef double float64;
+typedef uint32_t Uint32;
+typedef uint16_t Uint16;
+typedef uint8_t Uint8;
+#include "packet.c"
+
+#define PACKETS 2000
+#define CROSS 200//packets sent each way between packet.c and packet.py
+
+static int failures = 0;
+
+//PacketSend is never called here, but packet.c refers to it
+Uint16 sendCharArray(SCIPORT* port, char* bytes, Uint16 length) {
+	return 0;
+}
+
+/**
+ * A packet of random length whose data is half 0x00s, so COBS has work to do.
+ */
+static void randomPacket(PACKET* p) {
+	Uint16 i, n = rand() % (PACKET_MAX + 1);
+
+	PacketInit(p, rand() & 0xFF);
+	for (i = 0; i < n; i++) {
+		p->data[i] = (rand() % 2) ? rand() & 0xFF : 0;
+	}
+	p->length = n;
+}
+
+static int samePacket(PACKET* a, PACKET* b) {
+	Uint16 i;
+
+	if (a->type != b->type || a->length != b->length) {
+		return 0;
+	}
+	for (i = 0; i < a->length; i++) {
+		if ((a->data[i] & 0xFF) != (b->data[i] & 0xFF)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static void feed(PACKETRX* rx, char* bytes, Uint16 length) {
+	Uint16 i;
+
+	for (i = 0; i < length; i++) {
+		PacketRxByte(rx, bytes[i] & 0xFF);
+	}
+}
+
+/**
+ * packet.c to itself. One packet in eight is preceded by noise (ended by a
+ * 0x00, as a receiver joining mid-packet sees) and one in eight has a bit
+ * flipped.
+ */
+static void checkRoundTrip(void) {
+	PACKETRX rx;
+	PACKET sent, got;
+	char frame[PACKET_FRAME], noise[8];
+	Uint16 i, j, n, bad = 0, got1;
+
+	memset(&rx, 0, sizeof(rx));
+	rx.code = 0xFF;//as PacketRxInit leaves it
+	for (i = 0; i < PACKETS; i++) {
+		randomPacket(&sent);
+		n = PacketEncode(&sent, frame);
+		for (j = 0; j < n - 1; j++) {
+			if (frame[j] == 0) {
+				printf("FAIL: 0x00 inside a frame\n");
+				failures++;
+			}
+		}
+		if (rand() % 8 == 0) {
+			for (j = 0; j < 7; j++) {
+				noise[j] = 1 + rand() % 255;
+			}
+			noise[7] = 0;
+			feed(&rx, noise, 8);
+		}
+		if (rand() % 8 == 0) {
+			frame[rand() % (n - 1)] ^= 1 << (rand() % 8);
+			bad++;
+			feed(&rx, frame, n);
+			if (PacketReceive(&rx, &got)) {
+				printf("FAIL: corrupted packet %u accepted\n", i);
+				failures++;
+			}
+			continue;
+		}
+		feed(&rx, frame, n);
+		got1 = PacketReceive(&rx, &got);
+		if (!got1 || !samePacket(&sent, &got)) {
+			printf("FAIL: packet %u (type %u, %u bytes) didn't come back\n", i, sent.type, sent.length);
+			failures++;
+		}
+	}
+	if (rx.packets != PACKETS - bad || rx.dropped != 0) {
+		printf("FAIL: %lu good packets counted, expected %u\n", (unsigned long)rx.packets, PACKETS - bad);
+		failures++;
+	}
+	printf("%u packets round-tripped, %u corrupted ones thrown away\n", PACKETS - bad, bad);
+}
+
+/**
+ * @return A temporary file's name, made and closed
+ */
+static char* tempName(char* name) {
+	int fd;
+
+	strcpy(name, "/tmp/packetsXXXXXX");
+	fd = mkstemp(name);
+	if (fd < 0) {
+		return 0;
+	}
+	close(fd);
+	return name;
+}
+
+/**
+ * packet.c to packet.py and back. Both sides list packets as type,hex.
+ */
+static void checkPython(const char* script) {
+	PACKET sent[CROSS], got;
+	PACKETRX rx;
+	char frame[PACKET_FRAME], list[32], wire[32], cmd[512], line[2*PACKET_MAX + 16], want[2*PACKET_MAX + 16];
+	FILE *f, *py;
+	Uint16 i, j, n;
+	int c, k;
+
+	if (access(script, R_OK) != 0 || !tempName(list) || !tempName(wire)) {
+		printf("FAIL: can't find %s (pass its path) or make temporary files\n", script);
+		failures++;
+		return;
+	}
+	for (i = 0; i < CROSS; i++) {
+		randomPacket(&sent[i]);
+	}
+
+	//PacketEncode to packet.py
+	f = fopen(wire, "wb");
+	for (i = 0; i < CROSS; i++) {
+		n = PacketEncode(&sent[i], frame);
+		for (j = 0; j < n; j++) {
+			fputc(frame[j] & 0xFF, f);
+		}
+	}
+	fclose(f);
+	snprintf(cmd, sizeof(cmd), "python3 \"%s\" %s 2>/dev/null", script, wire);
+	py = popen(cmd, "r");
+	for (i = 0; py && i < CROSS; i++) {
+		k = sprintf(want, "%u,", sent[i].type);
+		for (j = 0; j < sent[i].length; j++) {
+			k += sprintf(want + k, "%02x", sent[i].data[j] & 0xFF);
+		}
+		if (!fgets(line, sizeof(line), py) || strncmp(line, want, k) != 0 || line[k] != '\n') {
+			printf("FAIL: packet.py decoded packet %u as %s", i, line);
+			failures++;
+			break;
+		}
+	}
+	if (!py || pclose(py) != 0) {
+		printf("FAIL: %s didn't run\n", cmd);
+		failures++;
+		return;
+	}
+
+	//packet.py to PacketRxByte
+	f = fopen(list, "w");
+	for (i = 0; i < CROSS; i++) {
+		fprintf(f, "%u,", sent[i].type);
+		for (j = 0; j < sent[i].length; j++) {
+			fprintf(f, "%02x", sent[i].data[j] & 0xFF);
+		}
+		fprintf(f, "\n");
+	}
+	fclose(f);
+	snprintf(cmd, sizeof(cmd), "python3 \"%s\" --frame %s", script, list);
+	py = popen(cmd, "r");
+	memset(&rx, 0, sizeof(rx));
+	rx.code = 0xFF;
+	i = 0;
+	while (py && (c = fgetc(py)) != EOF) {
+		PacketRxByte(&rx, c);
+		if (PacketReceive(&rx, &got)) {
+			if (i >= CROSS || !samePacket(&sent[i], &got)) {
+				printf("FAIL: packet %u framed by packet.py decoded wrong\n", i);
+				failures++;
+			}
+			i++;
+		}
+	}
+	if (py) {
+		pclose(py);
+	}
+	if (i != CROSS || rx.crcerrors || rx.errors) {
+		printf("FAIL: %u of %u packets framed by packet.py decoded\n", i, CROSS);
+		failures++;
+	}
+	remove(list);
+	remove(wire);
+	printf("%u packets each way between packet.c and packet.py\n", CROSS);
+}
+
+int main(int argc, char** argv) {
+	srand(1);
+	checkRoundTrip();
+	checkPython((argc > 1) ? argv[1] : "System Libraries/SCI Library/packet.py");
+	printf(failures ? "%d FAILED\n" : "ok\n", failures);
+	return failures != 0;
+}
@@ -1,319 +1,602 @@
-/**
- * @file sci.c
- * @author Pavel Komarov <pkomarov@gatech.edu> 941-545-7573
- * @brief A library makes communicating over SCI simple
- * @ingroup Digital
- * @version 2
- *
- * http://solarracing.gatech.edu/wiki/Main_Page
- * Initialize and use SCI with relative ease.
- */
-#include "F2806x_Device.h"
-#include "sci.h"
-#include "string.h"
-
-/**
- * Pass SCIPINs corresponding to GPIO pins you wish to make SCI .
- *
- * @param scisys A or B
- * @param in An SCIPIN to be used for input to the microcontroller
- * @param out An SCIPIN to be used for output from the microcontroller
- *
- */
-void SciInit(SCIPIN in, SCIPIN out) {
-
-	//The pin-assignment values are too unique to do some clever bitwise ops
-	//I have just used couple of switches.
-
-	//set up input pin
-	switch (in) {
-		case Ain7:
-			GpioCtrlRegs.GPAPUD.bit.GPIO7 = 0;     // Enable pull-up for GPIO7  (SCIRXDA)
-			GpioCtrlRegs.GPAQSEL1.bit.GPIO7 = 3;   // Asynch input GPIO7 (SCIRXDA)
-			GpioCtrlRegs.GPAMUX1.bit.GPIO7 = 2;    // Configure GPIO7 for SCIRXDA operation
-			break;
-		case Ain28:
-			GpioCtrlRegs.GPAPUD.bit.GPIO28 = 0;    // Enable pull-up for GPIO28 (SCIRXDA)
-			GpioCtrlRegs.GPAQSEL2.bit.GPIO28 = 3;  // Asynch input GPIO28 (SCIRXDA)
-			GpioCtrlRegs.GPAMUX2.bit.GPIO28 = 1;   // Configure GPIO28 for SCIRXDA operation
-			break;
-		case Bin11:
-			GpioCtrlRegs.GPAPUD.bit.GPIO11 = 0;    // Enable pull-up for GPIO11 (SCIRXDB)
-			GpioCtrlRegs.GPAQSEL1.bit.GPIO11 = 3;  // Asynch input GPIO11 (SCIRXDB)
-			GpioCtrlRegs.GPAMUX1.bit.GPIO11 = 2;   // Configure GPIO11 for SCIRXDB operation
-			break;
-		case Bin15:
-			GpioCtrlRegs.GPAPUD.bit.GPIO15 = 0;    // Enable pull-up for GPIO15 (SCIRXDB)
-			GpioCtrlRegs.GPAQSEL1.bit.GPIO15 = 3;  // Asynch input GPIO15 (SCIRXDB)
-			GpioCtrlRegs.GPAMUX1.bit.GPIO15 = 2;   // Configure GPIO15 for SCIRXDB operation
-			break;
-		case Bin19:
-			GpioCtrlRegs.GPAPUD.bit.GPIO19 = 0;    // Enable pull-up for GPIO19 (SCIRXDB)
-			GpioCtrlRegs.GPAQSEL2.bit.GPIO19 = 3;  // Asynch input GPIO19 (SCIRXDB)
-			GpioCtrlRegs.GPAMUX2.bit.GPIO19 = 2;   // Configure GPIO19 for SCIRXDB operation
-			break;
-		case Bin23:
-			GpioCtrlRegs.GPAPUD.bit.GPIO23 = 0;    // Enable pull-up for GPIO23 (SCIRXDB)
-			GpioCtrlRegs.GPAQSEL2.bit.GPIO23 = 3;  // Asynch input GPIO23 (SCIRXDB)
-			GpioCtrlRegs.GPAMUX2.bit.GPIO23 = 3;   // Configure GPIO23 for SCIRXDB operation
-			break;
-		case Bin41:
-			GpioCtrlRegs.GPBPUD.bit.GPIO41 = 0;    // Enable pull-up for GPIO41 (SCIRXDB)
-			GpioCtrlRegs.GPBQSEL1.bit.GPIO41 = 3;  // Asynch input GPIO41 (SCIRXDB)
-			GpioCtrlRegs.GPBMUX1.bit.GPIO41 = 2;   // Configure GPIO41 for SCIRXDB operation
-			break;
-		case Bin44:
-			GpioCtrlRegs.GPBPUD.bit.GPIO44 = 0;    // Enable pull-up for GPIO44 (SCIRXDB)
-			GpioCtrlRegs.GPBQSEL1.bit.GPIO44 = 3;  // Asynch input GPIO44 (SCIRXDB)
-			GpioCtrlRegs.GPBMUX1.bit.GPIO44 = 2;   // Configure GPIO44 for SCIRXDB operation
-			break;
-	}
-
-	//set up output pin
-	switch (out) {
-		case Aout12:
-			GpioCtrlRegs.GPAPUD.bit.GPIO12 = 0;	   // Enable pull-up for GPIO12 (SCITXDA)
-			GpioCtrlRegs.GPAMUX1.bit.GPIO12 = 2;   // Configure GPIO12 for SCITXDA operation
-			break;
-		case Aout29:
-			GpioCtrlRegs.GPAPUD.bit.GPIO29 = 0;	   // Enable pull-up for GPIO29 (SCITXDA)
-			GpioCtrlRegs.GPAMUX2.bit.GPIO29 = 1;   // Configure GPIO29 for SCITXDA operation
-			break;
-		case Bout9:
-			GpioCtrlRegs.GPAPUD.bit.GPIO9 = 0;	   // Enable pull-up for GPIO9 (SCITXDB)
-			GpioCtrlRegs.GPAMUX1.bit.GPIO9 = 2;    // Configure GPIO9 for SCITXDB operation
-			break;
-		case Bout14:
-			GpioCtrlRegs.GPAPUD.bit.GPIO14 = 0;	   // Enable pull-up for GPIO14 (SCITXDB)
-			GpioCtrlRegs.GPAMUX1.bit.GPIO14 = 2;   // Configure GPIO14 for SCITXDB operation
-			break;
-		case Bout18:
-			GpioCtrlRegs.GPAPUD.bit.GPIO18 = 0;	   // Enable pull-up for GPIO18 (SCITXDB)
-			GpioCtrlRegs.GPAMUX2.bit.GPIO18 = 2;   // Configure GPIO18 for SCITXDB operation
-			break;
-		case Bout22:
-			GpioCtrlRegs.GPAPUD.bit.GPIO22 = 0;	   // Enable pull-up for GPIO22 (SCITXDB)
-			GpioCtrlRegs.GPAMUX2.bit.GPIO22 = 3;   // Configure GPIO22 for SCITXDB operation
-			break;
-		case Bout40:
-			GpioCtrlRegs.GPBPUD.bit.GPIO40 = 0;	   // Enable pull-up for GPIO40 (SCITXDB)
-			GpioCtrlRegs.GPBMUX1.bit.GPIO40 = 2;   // Configure GPIO40 for SCITXDB operation
-			break;
-		case Bout58:
-			GpioCtrlRegs.GPBPUD.bit.GPIO58 = 0;	   // Enable pull-up for GPIO58 (SCITXDB)
-			GpioCtrlRegs.GPBMUX2.bit.GPIO58 = 2;   // Configure GPIO58 for SCITXDB operation
-			break;
-	}
-
-	//init sci module control registers and fifo
-	if (in == Ain7 || in == Ain28) {
-		SysCtrlRegs.PCLKCR0.bit.SCIAENCLK = 1;//enable clock to SCIA
-		asm(" NOP");
-		asm(" NOP");
-
-		SciaRegs.SCICCR.all = 0x7;//one stop bit, odd parity, parity disabled,
-									//loop-back disabled, character length = 8 (See Table
-									//13-9 in Technical Reference Manual)
-		SciaRegs.SCICTL1.all = 0x3;//TX enabled, RX enabled, skip reset state, disable
-									//RXERR, SLEEP, TXWAKE (see Table 13-10 in Tech Ref Man)
-		SciaRegs.SCICTL2.all = 0x0;//see Table 13-12 in Tech Ref Man
-
-		SciaRegs.SCIFFTX.all = 0xE404;//SCI reset, SCI FIFO enhancements are enabled,
-									//Re-enable transmit FIFO operation, clear TXFFINT flag,
-									//set buffer size to 4 (see Table 13-15 in Technical
-									//Reference Manual)
-		SciaRegs.SCIFFRX.all = 0x2424;//Re-enable receive FIFO operation,
-									//clear RXFFINT bit, set buffer size to 4
-									//(see Table 13-16 in Technical Reference Manual)
-		SciaRegs.SCIFFCT.all = 0;//see Table 13-17 in Technical Reference Manual
-									//NO autobaud
-		SciaRegs.SCICTL1.bit.SWRESET = 1;
-	} else {
-		SysCtrlRegs.PCLKCR0.bit.SCIBENCLK = 1;//enable clock to SCIB
-		asm(" NOP");
-		asm(" NOP");
-
-		ScibRegs.SCICCR.all =0x7;//see above comments
-		ScibRegs.SCICTL1.all =0x3;
-		ScibRegs.SCICTL2.all =0x0;
-
-		ScibRegs.SCIFFTX.all=0xE404;//see above comments
-		ScibRegs.SCIFFRX.all=0x2424;
-		ScibRegs.SCIFFCT.all=0x0;
-		ScibRegs.SCICTL1.bit.SWRESET = 1;
-	}
-}//holy crap
-
-
-/**
- * Set the SCI baud rate in kHz. Do this only after initializing the module with
- * SciInit. Note this method requires knowledge of the system clock frequency (in MHz).
- * Make a call to getfclk from the Clock Library if needed.
- *
- * Note this method is not completely fool-proof: not all combinations of fclk and
- * baud rate are possible. For example, if baud needs to be < 350 Hz for fclk =
- * 180MHz (its max possible value), then the low-speed clock will need to be set
- * to some fraction of fclk. Here I have left the low-speed clock as large as
- * possible to increase fidelity between desired and actually-set baud rate.
- *
- * @param scisys A or B
- * @param fclk The system clock frequency in MHz as set with SysClkInit and obtained with getfclk
- * @param baudrate The desired baud rate of the sci module in kHz
- */
-void SetSciBaudRate(char scisys, float32 fclk, float32 baudrate) {
-	SysCtrlRegs.LOSPCP.all = 0x0000;//low-speed clock = sysclk
-								//see Table 1-19 in Tech Ref Man
-	asm(" NOP");
-	asm(" NOP");
-
-	Uint16 brr = fclk*1000/(8*baudrate)-1;//find brr with formula from Table 13-11
-										//of Tech Ref Man. x1000 to put MHz in kHz.
-	switch (scisys) {
-		case 'A':
-			SciaRegs.SCICTL1.bit.SWRESET = 0;//is this necessary? It works.
-			SciaRegs.SCILBAUD = brr;//truncated
-			SciaRegs.SCIHBAUD = (brr >> 8);
-			SciaRegs.SCICTL1.bit.SWRESET = 1;//relinquish from reset mode
-			break;
-		case 'B':
-			ScibRegs.SCICTL1.bit.SWRESET = 0;
-			ScibRegs.SCILBAUD = brr;
-			ScibRegs.SCIHBAUD = (brr >> 8);
-			ScibRegs.SCICTL1.bit.SWRESET = 1;
-			break;
-	}
-
-}
-
-/**
- * Send a character to the SCI pin.
- *
- * @param scisys A or B
- * @param c The character to send to the SCI module.
- */
-void sendCharacter(char scisys, char c) {
-	switch (scisys) {
-		case'A':
-			while (SciaRegs.SCIFFTX.bit.TXFFST != 0) {}//wait for current transmit to finish
-			SciaRegs.SCITXBUF = c;//write new message element
-			break;
-		case 'B':
-			while (ScibRegs.SCIFFTX.bit.TXFFST != 0) {}//wait for current transmit to finish
-			ScibRegs.SCITXBUF = c;//write new message element
-			break;
-	}
-}
-
-/**
- * Send a byte array via SCI. Note this function is BLOCKING: no other code will be
- * executed while this function is running (unless that other code is an ISR).
- *
- * @param scisys A or B
- * @param arr Data to be sent.
- * @param len The length of the data.
- */
-void sendCharArray(char scisys, char* arr, Uint16 len) {
-	Uint16 i;
-	for(i = 0; i < len; i++) {
-		sendCharacter(scisys, arr[i]);
-	}
-}
-
-/**
- * Send a string via SCI. Note this function is BLOCKING: no other code will be
- * executed while this function is running (unless that other code is an ISR).
- *
- * @param scisys A or B
- * @param arr A string to be sent. No length parameter necessary.
- */
-void sendString(char scisys, char* str) {
-	sendCharArray(scisys, str, strlen(str)+1);//+1 for null character
-}
-
-/**
- * Read from the RX register when its value changes.
- *
- * @param scisys A or B
- * @return The character read.
- */
-char recieveChar(char scisys) {
-		switch (scisys) {
-		case 'A':
-			while (SciaRegs.SCIFFRX.bit.RXFFST == 0) {} //wait for a change
-			return SciaRegs.SCIRXBUF.all;
-		case 'B':
-			while (ScibRegs.SCIFFRX.bit.RXFFST == 0) {} //wait for a change
-			return ScibRegs.SCIRXBUF.all;
-		default:
-			return NULL;//to make the compiler stop whining
-	}
-}
-
-/**
- * Receives data as a byte array.
- *
- * @param scisys A or B
- * @param arr A pointer to a data-buffer to be loaded with data.
- * @param len The length of the message to be recieved.
- */
-void recieveCharArray(char scisys, char* arr, Uint16 len) {
-	Uint16 i = 0;
-	while(i < len) {
-		arr[i] = recieveChar(scisys);
-		i++;
-	}
-}
-
-/**
- * Receives a message and puts it in a null-terminated string. Note that the
- * null-termination is done inside, so pass any character array and get back
- * a string.
- *
- * @param scisys A or B
- * @param str A character array to be filled with null-terminated data. No
- * 				length specification necessary.
- * @return -1 if the string recieved has not ended by the time the end of the
- * 				data-buffer is reached, +1 if there is no error
- */
-signed char recieveString(char scisys, char* str) {
-	Uint16 i = 0;
-	char c = 't';
-	while(c != '\0') {
-		if (i > strlen(str)) {//strlen("thing") = 5, and ['t','h','i','n','g','\0'] has indices 0->5
-			return -1;
-		}
-		c = recieveChar(scisys);
-		str[i] = c;
-		i++;
-	}
-	return 1;
-}
-
-/**
- * UNTESTED
- * Enable interrupts from the SCI
- *
- * @param scisys A or B
- * @param sendISR A function pointer to an interrupt to be executed when data is sent
- * @param recieveISR A function pointer to an interrupt to be executed when data is recieved
- */
-void EnableSciInterrupts(char scisys) {
-	switch (scisys) {
-		case 'A':
-			SciaRegs.SCIFFTX.bit.SCIFFENA = 1;//enable SCIA FIFO
-			SciaRegs.SCIFFTX.bit.TXFFIENA = 1;//enable transmit interrupts from the SCI module
-			SciaRegs.SCIFFTX.bit.TXFFIL = 4;//interrupts occur when fifo holds 4 words.
-			SciaRegs.SCIFFRX.bit.RXFFIENA = 1;//enable recieve interrupts from the SCI module
-			SciaRegs.SCIFFRX.bit.RXFFIL = 4;//interrupts occur when fifo holds 4 words.
-			break;
-		case 'B':
-			ScibRegs.SCIFFTX.bit.SCIFFENA = 1;//enable SCIB FIFO
-			ScibRegs.SCIFFTX.bit.TXFFIENA = 1;//enable transmit interrupts from the SCI module
-			ScibRegs.SCIFFTX.bit.TXFFIL = 4;//interrupts occur when fifo holds 4 words.
-			ScibRegs.SCIFFRX.bit.RXFFIENA = 1;//enable recieve interrupts from the SCI module
-			ScibRegs.SCIFFRX.bit.RXFFIL = 4;//interrupts occur when fifo holds 4 words.
-			break;
-	}
-}
-
-
+/**
+ * @file sci.c
+ * @author Pavel Komarov <pkomarov@gatech.edu> 941-545-7573
+ * @brief A library makes communicating over SCI simple
+ * @ingroup Digital
+ * @version 2
+ *
+ * http://solarracing.gatech.edu/wiki/Main_Page
+ * Initialize and use SCI with relative ease.
+ */
+#include "F2806x_Device.h"
+#include "sci.h"
+#include "string.h"
+
+SCIPORT xscia = {&SciaRegs, 'A'};
+SCIPORT xscib = {&ScibRegs, 'B'};
+
+/**
+ * Pass SCIPINs corresponding to GPIO pins you wish to make SCI .
+ *
+ * @param in An SCIPIN to be used for input to the microcontroller
+ * @param out An SCIPIN to be used for output from the microcontroller
+ * @return The port the pins belong to (SCIA or SCIB), to pass to every other
+ * 				function here
+ */
+SCIPORT* SciInit(SCIPIN in, SCIPIN out) {
+	SCIPORT* port;
+	volatile struct SCI_REGS* regs;
+
+	//The pin-assignment values are too unique to do some clever bitwise ops
+	//I have just used couple of switches.
+
+	//set up input pin
+	switch (in) {
+		case Ain7:
+			GpioCtrlRegs.GPAPUD.bit.GPIO7 = 0;     // Enable pull-up for GPIO7  (SCIRXDA)
+			GpioCtrlRegs.GPAQSEL1.bit.GPIO7 = 3;   // Asynch input GPIO7 (SCIRXDA)
+			GpioCtrlRegs.GPAMUX1.bit.GPIO7 = 2;    // Configure GPIO7 for SCIRXDA operation
+			break;
+		case Ain28:
+			GpioCtrlRegs.GPAPUD.bit.GPIO28 = 0;    // Enable pull-up for GPIO28 (SCIRXDA)
+			GpioCtrlRegs.GPAQSEL2.bit.GPIO28 = 3;  // Asynch input GPIO28 (SCIRXDA)
+			GpioCtrlRegs.GPAMUX2.bit.GPIO28 = 1;   // Configure GPIO28 for SCIRXDA operation
+			break;
+		case Bin11:
+			GpioCtrlRegs.GPAPUD.bit.GPIO11 = 0;    // Enable pull-up for GPIO11 (SCIRXDB)
+			GpioCtrlRegs.GPAQSEL1.bit.GPIO11 = 3;  // Asynch input GPIO11 (SCIRXDB)
+			GpioCtrlRegs.GPAMUX1.bit.GPIO11 = 2;   // Configure GPIO11 for SCIRXDB operation
+			break;
+		case Bin15:
+			GpioCtrlRegs.GPAPUD.bit.GPIO15 = 0;    // Enable pull-up for GPIO15 (SCIRXDB)
+			GpioCtrlRegs.GPAQSEL1.bit.GPIO15 = 3;  // Asynch input GPIO15 (SCIRXDB)
+			GpioCtrlRegs.GPAMUX1.bit.GPIO15 = 2;   // Configure GPIO15 for SCIRXDB operation
+			break;
+		case Bin19:
+			GpioCtrlRegs.GPAPUD.bit.GPIO19 = 0;    // Enable pull-up for GPIO19 (SCIRXDB)
+			GpioCtrlRegs.GPAQSEL2.bit.GPIO19 = 3;  // Asynch input GPIO19 (SCIRXDB)
+			GpioCtrlRegs.GPAMUX2.bit.GPIO19 = 2;   // Configure GPIO19 for SCIRXDB operation
+			break;
+		case Bin23:
+			GpioCtrlRegs.GPAPUD.bit.GPIO23 = 0;    // Enable pull-up for GPIO23 (SCIRXDB)
+			GpioCtrlRegs.GPAQSEL2.bit.GPIO23 = 3;  // Asynch input GPIO23 (SCIRXDB)
+			GpioCtrlRegs.GPAMUX2.bit.GPIO23 = 3;   // Configure GPIO23 for SCIRXDB operation
+			break;
+		case Bin41:
+			GpioCtrlRegs.GPBPUD.bit.GPIO41 = 0;    // Enable pull-up for GPIO41 (SCIRXDB)
+			GpioCtrlRegs.GPBQSEL1.bit.GPIO41 = 3;  // Asynch input GPIO41 (SCIRXDB)
+			GpioCtrlRegs.GPBMUX1.bit.GPIO41 = 2;   // Configure GPIO41 for SCIRXDB operation
+			break;
+		case Bin44:
+			GpioCtrlRegs.GPBPUD.bit.GPIO44 = 0;    // Enable pull-up for GPIO44 (SCIRXDB)
+			GpioCtrlRegs.GPBQSEL1.bit.GPIO44 = 3;  // Asynch input GPIO44 (SCIRXDB)
+			GpioCtrlRegs.GPBMUX1.bit.GPIO44 = 2;   // Configure GPIO44 for SCIRXDB operation
+			break;
+	}
+
+	//set up output pin
+	switch (out) {
+		case Aout12:
+			GpioCtrlRegs.GPAPUD.bit.GPIO12 = 0;	   // Enable pull-up for GPIO12 (SCITXDA)
+			GpioCtrlRegs.GPAMUX1.bit.GPIO12 = 2;   // Configure GPIO12 for SCITXDA operation
+			break;
+		case Aout29:
+			GpioCtrlRegs.GPAPUD.bit.GPIO29 = 0;	   // Enable pull-up for GPIO29 (SCITXDA)
+			GpioCtrlRegs.GPAMUX2.bit.GPIO29 = 1;   // Configure GPIO29 for SCITXDA operation
+			break;
+		case Bout9:
+			GpioCtrlRegs.GPAPUD.bit.GPIO9 = 0;	   // Enable pull-up for GPIO9 (SCITXDB)
+			GpioCtrlRegs.GPAMUX1.bit.GPIO9 = 2;    // Configure GPIO9 for SCITXDB operation
+			break;
+		case Bout14:
+			GpioCtrlRegs.GPAPUD.bit.GPIO14 = 0;	   // Enable pull-up for GPIO14 (SCITXDB)
+			GpioCtrlRegs.GPAMUX1.bit.GPIO14 = 2;   // Configure GPIO14 for SCITXDB operation
+			break;
+		case Bout18:
+			GpioCtrlRegs.GPAPUD.bit.GPIO18 = 0;	   // Enable pull-up for GPIO18 (SCITXDB)
+			GpioCtrlRegs.GPAMUX2.bit.GPIO18 = 2;   // Configure GPIO18 for SCITXDB operation
+			break;
+		case Bout22:
+			GpioCtrlRegs.GPAPUD.bit.GPIO22 = 0;	   // Enable pull-up for GPIO22 (SCITXDB)
+			GpioCtrlRegs.GPAMUX2.bit.GPIO22 = 3;   // Configure GPIO22 for SCITXDB operation
+			break;
+		case Bout40:
+			GpioCtrlRegs.GPBPUD.bit.GPIO40 = 0;	   // Enable pull-up for GPIO40 (SCITXDB)
+			GpioCtrlRegs.GPBMUX1.bit.GPIO40 = 2;   // Configure GPIO40 for SCITXDB operation
+			break;
+		case Bout58:
+			GpioCtrlRegs.GPBPUD.bit.GPIO58 = 0;	   // Enable pull-up for GPIO58 (SCITXDB)
+			GpioCtrlRegs.GPBMUX2.bit.GPIO58 = 2;   // Configure GPIO58 for SCITXDB operation
+			break;
+	}
+
+	//init sci module control registers and fifo
+	if (in == Ain7 || in == Ain28) {
+		port = &xscia;
+		SysCtrlRegs.PCLKCR0.bit.SCIAENCLK = 1;//enable clock to SCIA
+	} else {
+		port = &xscib;
+		SysCtrlRegs.PCLKCR0.bit.SCIBENCLK = 1;//enable clock to SCIB
+	}
+	asm(" NOP");
+	asm(" NOP");
+
+	regs = port->regs;
+	regs->SCICCR.all = 0x7;//one stop bit, odd parity, parity disabled,
+							//loop-back disabled, character length = 8 (See Table
+							//13-9 in Technical Reference Manual)
+	regs->SCICTL1.all = 0x3;//TX enabled, RX enabled, skip reset state, disable
+							//RXERR, SLEEP, TXWAKE (see Table 13-10 in Tech Ref Man)
+	regs->SCICTL2.all = 0x0;//see Table 13-12 in Tech Ref Man
+
+	regs->SCIFFTX.all = 0xE404;//SCI reset, SCI FIFO enhancements are enabled,
+							//Re-enable transmit FIFO operation, clear TXFFINT flag,
+							//set buffer size to 4 (see Table 13-15 in Technical
+							//Reference Manual)
+	regs->SCIFFRX.all = 0x2424;//Re-enable receive FIFO operation,
+							//clear RXFFINT bit, set buffer size to 4
+							//(see Table 13-16 in Technical Reference Manual)
+	regs->SCIFFCT.all = 0;//see Table 13-17 in Technical Reference Manual
+							//NO autobaud
+	regs->SCICTL1.bit.SWRESET = 1;
+
+	port->buffered = 0;
+	port->rxhook = 0;
+	return port;
+}//holy crap
+
+
+/**
+ * The baud rate BRR gives from a low-speed clock of lsp kHz (Table 13-11 of
+ * the Tech Ref Man).
+ */
+static float32 sciBaud(float32 lsp, Uint16 brr) {
+	return (brr == 0) ? lsp/16 : lsp/(8*(brr + 1.0));
+}
+
+/**
+ * The low-speed clock, in kHz, for a LOSPCP value (Table 1-19 of the Tech Ref
+ * Man): SYSCLK/(2*LOSPCP), or SYSCLK itself for 0.
+ */
+static float32 sciLowSpeed(float32 fclk, Uint16 lospcp) {
+	return (lospcp == 0) ? fclk*1000 : fclk*1000/(2*lospcp);
+}
+
+/**
+ * The BRR closest to baudrate from a low-speed clock of lsp kHz. BRR is
+ * rounded, not truncated: at 50MHz, truncating put 460.8k out by 4.3%.
+ *
+ * @return How far off that leaves the rate, in percent either way
+ */
+static float32 sciSolve(float32 lsp, float32 baudrate, Uint16* brr) {
+	float32 err, besterr = 1e9;
+	int32 guess = (int32)(lsp/(8*baudrate) - 1);//the BRR that would be exact, truncated
+	int16 k;
+
+	for (k = -1; k <= 1; k++) {//the integers around it (BRR = 0 gives the same as 1)
+		if (guess + k < 0 || guess + k > 0xFFFF) {
+			continue;
+		}
+		err = (sciBaud(lsp, guess + k) - baudrate)/baudrate*100;
+		if (err < 0) {
+			err = -err;
+		}
+		if (err < besterr) {
+			besterr = err;
+			*brr = guess + k;
+		}
+	}
+	return besterr;
+}
+
+/**
+ * Load BRR and note what it gives.
+ */
+static void sciSetBrr(SCIPORT* port, float32 fclk, Uint16 lospcp, Uint16 brr, float32 baudrate) {
+	port->regs->SCICTL1.bit.SWRESET = 0;//is this necessary? It works.
+	port->regs->SCILBAUD = brr;
+	port->regs->SCIHBAUD = (brr >> 8);
+	port->regs->SCICTL1.bit.SWRESET = 1;//relinquish from reset mode
+
+	port->lospcp = lospcp;
+	port->baud = sciBaud(sciLowSpeed(fclk, lospcp), brr);
+	port->bauderr = (port->baud - baudrate)/baudrate*100;
+}
+
+/**
+ * Set the SCI baud rate in kHz. Do this only after initializing the module with
+ * SciInit. Note this method requires knowledge of the system clock frequency (in MHz).
+ * Make a call to getfclk from the Clock Library if needed.
+ *
+ * Every low-speed clock prescaler (LOSPCP) is tried, and the one whose BRR
+ * comes closest to baudrate is used. LOSPCP is shared with the other SCI port,
+ * SPI and McBSP, though, so the current one is kept unless another beats it
+ * by more than SCI_BAUD_MARGIN percent, and if the other port has been set up,
+ * only LOSPCPs that keep it within SCI_BAUD_TOLERANCE are tried; its BRR is
+ * redone for the new one. SPI and McBSP can't be redone from here: if this
+ * returns 2, set their rates again.
+ *
+ * If nothing gets within SCI_BAUD_TOLERANCE, nothing is changed and 0 is
+ * returned; a UART a few percent off its partner garbles bytes only some of
+ * the time, which is worse than not working at all.
+ *
+ * @param port The port, as returned by SciInit
+ * @param fclk The system clock frequency in MHz as set with SysClkInit and obtained with getfclk
+ * @param baudrate The desired baud rate of the sci module in kHz
+ * @return 1 if set, with the rate actually set in port->baud and its error in
+ * 				port->bauderr; 2 if set, but only by changing LOSPCP; 0 if no
+ * 				setting was close enough
+ */
+Uint16 SetSciBaudRate(SCIPORT* port, float32 fclk, float32 baudrate) {
+	SCIPORT* other = (port == &xscia) ? &xscib : &xscia;
+	float32 otherrate = other->baud/(1 + other->bauderr/100);//what it was asked for
+	Uint16 now = SysCtrlRegs.LOSPCP.bit.LSPCLK;
+	Uint16 lospcp, brr, otherbrr, best = now, bestbrr = 0;
+	float32 lsp, err, nowerr, besterr;
+
+	nowerr = besterr = sciSolve(sciLowSpeed(fclk, now), baudrate, &bestbrr);
+	for (lospcp = 0; lospcp < 8; lospcp++) {
+		lsp = sciLowSpeed(fclk, lospcp);
+		if (lospcp == now || (other->baud != 0
+				&& sciSolve(lsp, otherrate, &otherbrr) > SCI_BAUD_TOLERANCE)) {
+			continue;
+		}
+		err = sciSolve(lsp, baudrate, &brr);
+		if (err < besterr && err < nowerr - SCI_BAUD_MARGIN) {//changing LOSPCP has to be worth it
+			besterr = err;
+			best = lospcp;
+			bestbrr = brr;
+		}
+	}
+	if (besterr > SCI_BAUD_TOLERANCE) {
+		return 0;
+	}
+
+	if (best != now) {
+		SysCtrlRegs.LOSPCP.bit.LSPCLK = best;//see Table 1-19 in Tech Ref Man
+		asm(" NOP");
+		asm(" NOP");
+		if (other->baud != 0) {
+			sciSolve(sciLowSpeed(fclk, best), otherrate, &otherbrr);
+			sciSetBrr(other, fclk, best, otherbrr, otherrate);
+		}
+	}
+	sciSetBrr(port, fclk, best, bestbrr, baudrate);
+	return (best != now) ? 2 : 1;
+}
+
+/**
+ * Start listening for the baud rate. The other end must then send 'A' or 'a',
+ * whose first bit the SCI times to set BRR itself (SCIFFCT.CDC/ABD, section
+ * 13.2.7 of the Tech Ref Man). Poll SciAutobaudDone until it returns 1. The
+ * low-speed clock is left as it is, so the slowest rate that can be found is
+ * that clock/(8*65536) and the fastest is best kept well below clock/100.
+ *
+ * @param port The port, as returned by SciInit
+ */
+void SciAutobaudStart(SCIPORT* port) {
+	volatile struct SCI_REGS* regs = port->regs;
+
+	regs->SCICTL1.bit.SWRESET = 0;
+	regs->SCIHBAUD = 0;
+	regs->SCILBAUD = 1;//anything but 0
+	regs->SCICTL1.bit.SWRESET = 1;
+	regs->SCIFFCT.bit.ABDCLR = 1;//clear any old detection
+	regs->SCIFFCT.bit.CDC = 1;//enable autobaud
+}
+
+/**
+ * See whether autobaud has locked on yet. Once it has, autobaud is turned off
+ * again, the 'A' is thrown away, and port->baud holds the rate found.
+ *
+ * @param port The port, as passed to SciAutobaudStart
+ * @param fclk The system clock frequency in MHz
+ * @return 1 once locked, 0 before
+ */
+Uint16 SciAutobaudDone(SCIPORT* port, float32 fclk) {
+	volatile struct SCI_REGS* regs = port->regs;
+	Uint16 brr;
+
+	if (!regs->SCIFFCT.bit.ABD) {
+		return 0;
+	}
+	regs->SCIFFCT.bit.CDC = 0;
+	regs->SCIFFCT.bit.ABDCLR = 1;
+	while (regs->SCIFFRX.bit.RXFFST) {//the 'A' (or a fragment of it)
+		brr = regs->SCIRXBUF.all;
+	}
+
+	brr = (regs->SCIHBAUD << 8) | (regs->SCILBAUD & 0xFF);
+	port->lospcp = SysCtrlRegs.LOSPCP.bit.LSPCLK;
+	port->baud = sciBaud(sciLowSpeed(fclk, port->lospcp), brr);
+	port->bauderr = 0;//nothing was asked for
+	return 1;
+}
+
+/**
+ * Send a character to the SCI pin. Waits only while the hardware FIFO is full.
+ * Bypasses the buffer, so don't mix it with buffered sends on the same port.
+ *
+ * @param port The port, as returned by SciInit
+ * @param c The character to send to the SCI module.
+ */
+void sendCharacter(SCIPORT* port, char c) {
+	volatile struct SCI_REGS* regs = port->regs;
+	while (regs->SCIFFTX.bit.TXFFST >= SCI_FIFO) {}//wait for room in the FIFO
+	regs->SCITXBUF = c;//write new message element
+}
+
+/**
+ * Send a byte array via SCI. If EnableSciInterrupts has been called for the
+ * port, the array is copied into the transmit buffer and this returns at once;
+ * the SCI TX interrupt sends it. A send that doesn't fit in the buffer is
+ * dropped whole rather than cut short. Otherwise this is BLOCKING: no other
+ * code will be executed while this function is running (unless that other
+ * code is an ISR).
+ *
+ * @param port The port, as returned by SciInit
+ * @param arr Data to be sent.
+ * @param len The length of the data.
+ * @return 1 if sent (or queued), 0 if the buffer was too full and nothing was
+ * 				sent
+ */
+Uint16 sendCharArray(SCIPORT* port, char* arr, Uint16 len) {
+	Uint16 i, head;
+
+	if (!port->buffered) {
+		for(i = 0; i < len; i++) {
+			sendCharacter(port, arr[i]);
+		}
+		return 1;
+	}
+
+	head = port->txhead;
+	if (len > ((port->txtail - head - 1) & (SCI_TX_SIZE - 1))) {//room left
+		port->txdropped++;
+		return 0;
+	}
+	for(i = 0; i < len; i++) {
+		port->tx[head] = arr[i];
+		head = (head + 1) & (SCI_TX_SIZE - 1);
+	}
+	port->txhead = head;//only now can the interrupt see it
+	port->regs->SCIFFTX.bit.TXFFIENA = 1;//(re)start the interrupt; it stops itself when tx is empty
+	return 1;
+}
+
+/**
+ * Send a string via SCI. See sendCharArray: returns at once if the port is
+ * buffered, and blocks otherwise.
+ *
+ * @param port The port, as returned by SciInit
+ * @param arr A string to be sent. No length parameter necessary.
+ * @return 1 if sent (or queued), 0 if dropped
+ */
+Uint16 sendString(SCIPORT* port, char* str) {
+	return sendCharArray(port, str, strlen(str)+1);//+1 for null character
+}
+
+/**
+ * Read a character, waiting for one if there is none yet.
+ *
+ * @param port The port, as returned by SciInit
+ * @return The character read.
+ */
+char recieveChar(SCIPORT* port) {
+	char c;
+
+	if (!port->buffered) {
+		while (port->regs->SCIFFRX.bit.RXFFST == 0) {} //wait for a change
+		return port->regs->SCIRXBUF.all;
+	}
+	while (port->rxtail == port->rxhead) {}//wait for the interrupt to bring one
+	c = port->rx[port->rxtail];
+	port->rxtail = (port->rxtail + 1) & (SCI_RX_SIZE - 1);
+	return c;
+}
+
+/**
+ * Take whatever has been received, up to max characters, without waiting.
+ * Needs EnableSciInterrupts.
+ *
+ * @param port The port, as returned by SciInit
+ * @param arr Where to put the characters
+ * @param max The most to take
+ * @return How many were taken
+ */
+Uint16 SciRead(SCIPORT* port, char* arr, Uint16 max) {
+	Uint16 n = 0;
+	Uint16 tail = port->rxtail;
+
+	while (n < max && tail != port->rxhead) {
+		arr[n++] = port->rx[tail];
+		tail = (tail + 1) & (SCI_RX_SIZE - 1);
+	}
+	port->rxtail = tail;
+	return n;
+}
+
+/**
+ * @param port The port, as returned by SciInit
+ * @return Characters waiting in the transmit buffer (not counting the 4 the
+ * 				FIFO may hold). 0 once everything queued has gone to the FIFO.
+ */
+Uint16 SciTxPending(SCIPORT* port) {
+	return (port->txhead - port->txtail) & (SCI_TX_SIZE - 1);
+}
+
+/**
+ * @param port The port, as returned by SciInit
+ * @return Characters received and not yet read
+ */
+Uint16 SciRxCount(SCIPORT* port) {
+	return (port->rxhead - port->rxtail) & (SCI_RX_SIZE - 1);
+}
+
+/**
+ * @param port The port, as returned by SciInit
+ * @return Sends dropped because the transmit buffer was full, plus bytes lost
+ * 				because the receive buffer or FIFO was full
+ */
+Uint32 SciDropped(SCIPORT* port) {
+	return port->txdropped + port->rxdropped + port->rxoverruns;
+}
+
+/**
+ * Receives data as a byte array.
+ *
+ * @param port The port, as returned by SciInit
+ * @param arr A pointer to a data-buffer to be loaded with data.
+ * @param len The length of the message to be recieved.
+ */
+void recieveCharArray(SCIPORT* port, char* arr, Uint16 len) {
+	Uint16 i = 0;
+	while(i < len) {
+		arr[i] = recieveChar(port);
+		i++;
+	}
+}
+
+/**
+ * Receives a message and puts it in a null-terminated string. Note that the
+ * null-termination is done inside, so pass any character array and get back
+ * a string.
+ *
+ * @param port The port, as returned by SciInit
+ * @param str A character array to be filled with null-terminated data. No
+ * 				length specification necessary.
+ * @return -1 if the string recieved has not ended by the time the end of the
+ * 				data-buffer is reached, +1 if there is no error
+ */
+signed char recieveString(SCIPORT* port, char* str) {
+	Uint16 i = 0;
+	char c = 't';
+	while(c != '\0') {
+		if (i > strlen(str)) {//strlen("thing") = 5, and ['t','h','i','n','g','\0'] has indices 0->5
+			return -1;
+		}
+		c = recieveChar(port);
+		str[i] = c;
+		i++;
+	}
+	return 1;
+}
+
+/**
+ * Make a port buffered: sends return at once and receiving never misses a
+ * character, with the SCI interrupts moving bytes between the FIFOs and
+ * software buffers. Call after SciInit and SetSciBaudRate, then register the
+ * port's two interrupts with the Interrupts Library, e.g. for SCIB:
+ *
+ *		SCIPORT* xtend = SciInit(Bin23, Bout22);
+ *		SetSciBaudRate(xtend, getfclk(), 115.2);
+ *		EnableSciInterrupts(xtend);
+ *		IsrInit(SCIBTX, &ScibTxIsr);
+ *		IsrInit(SCIBRX, &ScibRxIsr);
+ *
+ * The ISRs acknowledge the PIE themselves.
+ *
+ * @param port The port, as returned by SciInit
+ */
+void EnableSciInterrupts(SCIPORT* port) {
+	volatile struct SCI_REGS* regs = port->regs;
+
+	port->txhead = port->txtail = 0;
+	port->rxhead = port->rxtail = 0;
+	port->buffered = 1;
+
+	regs->SCIFFTX.bit.SCIFFENA = 1;//enable FIFO
+	regs->SCIFFTX.bit.TXFFIL = 1;//interrupt when the FIFO is down to 1 word, so it never runs dry
+	regs->SCIFFTX.bit.TXFFIENA = 0;//sendCharArray turns this on when there is something to send
+	regs->SCIFFTX.bit.TXFFINTCLR = 1;
+	regs->SCIFFRX.bit.RXFFIL = 1;//interrupt on every word: there is no receive timeout to catch
+								//the tail of a message that doesn't fill the FIFO
+	regs->SCIFFRX.bit.RXFFINTCLR = 1;
+	regs->SCIFFRX.bit.RXFFIENA = 1;//enable recieve interrupts from the SCI module
+}
+
+/**
+ * Top the TX FIFO up from the transmit buffer, and stop interrupting once the
+ * buffer is empty.
+ */
+static void sciTxIsr(SCIPORT* port) {
+	volatile struct SCI_REGS* regs = port->regs;
+	Uint16 tail = port->txtail;
+
+	while (tail != port->txhead && regs->SCIFFTX.bit.TXFFST < SCI_FIFO) {
+		regs->SCITXBUF = port->tx[tail];
+		tail = (tail + 1) & (SCI_TX_SIZE - 1);
+	}
+	port->txtail = tail;
+	if (tail == port->txhead) {
+		regs->SCIFFTX.bit.TXFFIENA = 0;//sendCharArray sets it again after adding more
+	}
+	regs->SCIFFTX.bit.TXFFINTCLR = 1;
+}
+
+/**
+ * Empty the RX FIFO into the receive buffer.
+ */
+static void sciRxIsr(SCIPORT* port) {
+	volatile struct SCI_REGS* regs = port->regs;
+	Uint16 head = port->rxhead;
+	Uint16 next, word;
+
+	while (regs->SCIFFRX.bit.RXFFST) {
+		word = regs->SCIRXBUF.all;
+		if (word & 0xC000) {//SCIFFFE or SCIFFPE
+			port->rxerrors++;
+		}
+		if (port->rxhook) {//e.g. a packet decoder: it gets the byte instead of rx
+			port->rxhook(port->rxhookarg, word & 0xFF);
+			continue;
+		}
+		next = (head + 1) & (SCI_RX_SIZE - 1);
+		if (next == port->rxtail) {
+			port->rxdropped++;
+		} else {
+			port->rx[head] = word & 0xFF;
+			head = next;
+		}
+	}
+	port->rxhead = head;
+	if (regs->SCIFFRX.bit.RXFFOVF) {
+		port->rxoverruns++;
+		regs->SCIFFRX.bit.RXFFOVRCLR = 1;
+	}
+	regs->SCIFFRX.bit.RXFFINTCLR = 1;
+}
+
+/**
+ * Register with IsrInit(SCIATX, ...) after EnableSciInterrupts(SCIA).
+ */
+interrupt void SciaTxIsr(void) {
+	sciTxIsr(&xscia);
+	PieCtrlRegs.PIEACK.all = PIEACK_GROUP9;
+}
+
+/**
+ * Register with IsrInit(SCIARX, ...) after EnableSciInterrupts(SCIA).
+ */
+interrupt void SciaRxIsr(void) {
+	sciRxIsr(&xscia);
+	PieCtrlRegs.PIEACK.all = PIEACK_GROUP9;
+}
+
+/**
+ * Register with IsrInit(SCIBTX, ...) after EnableSciInterrupts(SCIB).
+ */
+interrupt void ScibTxIsr(void) {
+	sciTxIsr(&xscib);
+	PieCtrlRegs.PIEACK.all = PIEACK_GROUP9;
+}
+
+/**
+ * Register with IsrInit(SCIBRX, ...) after EnableSciInterrupts(SCIB).
+ */
+interrupt void ScibRxIsr(void) {
+	sciRxIsr(&xscib);
+	PieCtrlRegs.PIEACK.all = PIEACK_GROUP9;
+}
+
+
@@ -1,24 +1,82 @@
-
-/*
- * In/out pin pairs should be in the same system (A or B).
- * I have not protected against cases when they are not.
- */
-typedef enum {
-    Ain7,			Ain28,			Aout12,
-    Aout29,			Bin11,			Bin15,
-    Bin19,			Bin23,			Bin41,
-    Bin44,			Bout9,			Bout14,
-    Bout18,			Bout22,			Bout40,
-    Bout58
-} SCIPIN;
-
-void SciInit(SCIPIN in, SCIPIN out);
-void SetSciBaudRate(char scisys, float32 fclk, float32 baudrate);
-
-void sendCharArray(char, char*, Uint16);
-void sendString(char, char*);
-void recieveCharArray(char, char*, Uint16);
-signed char recieveString(char, char*);
-
-//untested
-void EnableSciInterrupts(char);
+/*
+ * In/out pin pairs should be in the same system (A or B).
+ * I have not protected against cases when they are not.
+ */
+#ifndef SCI_H_
+#define SCI_H_
+
+typedef enum {
+    Ain7,			Ain28,			Aout12,
+    Aout29,			Bin11,			Bin15,
+    Bin19,			Bin23,			Bin41,
+    Bin44,			Bout9,			Bout14,
+    Bout18,			Bout22,			Bout40,
+    Bout58
+} SCIPIN;
+
+#define SCI_FIFO 4//depth of the hardware FIFOs
+#define SCI_TX_SIZE 256//software transmit buffer per port, once buffered. A power of 2
+#define SCI_RX_SIZE 128//software receive buffer per port. A power of 2
+#define SCI_BAUD_TOLERANCE 2.0//percent: SetSciBaudRate refuses rates further off than this
+#define SCI_BAUD_MARGIN 0.1//percent: how much worse the current LOSPCP may be and still be kept
+
+/*
+ * A port: SciInit hands one back, and every other call takes it. All that
+ * differs between ports is in here, so sending a byte is a pointer away from
+ * the registers rather than a switch on the port's name.
+ *
+ * Once EnableSciInterrupts has been called for a port, what it sends goes
+ * into tx, and the SCI TX interrupt tops the 4-deep hardware FIFO up from
+ * there; what it receives is moved from the FIFO into rx by the SCI RX
+ * interrupt. Only the main loop moves txhead and rxtail, and only the
+ * interrupts move txtail and rxhead, so neither side has to lock the other out.
+ */
+typedef struct {
+	volatile struct SCI_REGS* regs;
+	char name;//'A' or 'B'
+	float32 baud;//kHz, as actually set by SetSciBaudRate or found by autobaud
+	float32 bauderr;//percent that is off from what was asked for
+	Uint16 lospcp;//low-speed clock prescaler in use
+	Uint16 buffered;//set by EnableSciInterrupts
+	char tx[SCI_TX_SIZE];
+	volatile Uint16 txhead;//next free slot
+	volatile Uint16 txtail;//next to go into the FIFO
+	char rx[SCI_RX_SIZE];
+	volatile Uint16 rxhead;
+	volatile Uint16 rxtail;
+	Uint32 txdropped;//sends refused because tx was full
+	Uint32 rxdropped;//bytes lost because rx was full
+	Uint32 rxoverruns;//times the hardware FIFO overflowed before the interrupt got to it
+	Uint32 rxerrors;//bytes with framing or parity errors
+	void (*rxhook)(void* arg, Uint16 byte);//if set, the RX interrupt hands it each byte instead of
+	void* rxhookarg;						//putting it in rx (see PacketRxInit)
+} SCIPORT;
+
+extern SCIPORT xscia, xscib;
+#define SCIA (&xscia)
+#define SCIB (&xscib)
+
+SCIPORT* SciInit(SCIPIN in, SCIPIN out);
+Uint16 SetSciBaudRate(SCIPORT* port, float32 fclk, float32 baudrate);
+void SciAutobaudStart(SCIPORT* port);
+Uint16 SciAutobaudDone(SCIPORT* port, float32 fclk);
+
+void sendCharacter(SCIPORT*, char);
+Uint16 sendCharArray(SCIPORT*, char*, Uint16);
+Uint16 sendString(SCIPORT*, char*);
+char recieveChar(SCIPORT*);
+void recieveCharArray(SCIPORT*, char*, Uint16);
+signed char recieveString(SCIPORT*, char*);
+
+//buffered, interrupt-driven operation
+void EnableSciInterrupts(SCIPORT*);
+Uint16 SciRead(SCIPORT*, char*, Uint16);
+Uint16 SciTxPending(SCIPORT*);
+Uint16 SciRxCount(SCIPORT*);
+Uint32 SciDropped(SCIPORT*);
+interrupt void SciaTxIsr(void);
+interrupt void SciaRxIsr(void);
+interrupt void ScibTxIsr(void);
+interrupt void ScibRxIsr(void);
+
+#endif /* SCI_H_ */
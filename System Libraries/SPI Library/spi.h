@@ -1,2 +1,2 @@
-
-void SpiInit(void);
+
+void SpiInit(void);
@@ -0,0 +1,77 @@
+/**
+ * @brief This project tests the streaming mode of the ADC Library
+ * @ingroup Digital
+ * @version 0
+ *
+ * Three socs sample the motor phase currents at 100kHz off of CPU timer 0.
+ * DMA moves each set of results into a ping-pong buffer, so the CPU only
+ * hears about it once every 64 sets, rather than once per conversion as in
+ * adctest.c.
+ */
+#include "F2806x_Device.h"
+#include "28069Common.h"
+#include "clocks.h"
+#include "gpio.h"
+#include "interrupts.h"
+#include "adc.h"
+//Also relies on 28069_RAM_lnk.cmd, F2806x_CodeStartBranch.asm,
+//F2806x_Headers_nonBIOS.cmd
+//targetConfig is "TMS320F28069.ccxml"
+
+#define SETS 64//sets of 3 results per half-buffer
+
+interrupt void dmaISR(void);
+
+#pragma DATA_SECTION(buf, "DMARAML5");//the DMA can only reach L5-L8
+Uint16 buf[2*3*SETS];
+Uint32 loopcnt = 0, dmacnt = 0;
+Uint32 sum[3];
+
+//Code blocks in the preamble are labelled with the names
+//of the libraries in which functions-used-therein are defined.
+//Look in these to discover fundamental definitions.
+void main(void) {
+
+	EALLOW;//an assembly language thing required to allow access to system control registers
+	SysCtrlRegs.WDCR = 0x68;//disable watchdog
+	//clock
+		SysClkInit(EIGHTY);//set the system clock to 80MHz
+	//gpio
+		Uint8 out[1] = {34};//34 is a pin that toggles each time a half-buffer fills
+		GpioOutputsInit(out, 1);
+	//interrupts
+		IsrInit(DMACH1, &dmaISR);//note no ADCINT1 here: the DMA consumes it
+	//adc
+		AdcInit();
+		AdcSetClock(HALF);//40MHz, under the 45MHz limit and still plenty for 3 conversions at 100kHz
+		AdcSetupSOC(SOC0, ADCA0, TINT0t);//phase A
+		AdcSetupSOC(SOC1, ADCA1, TINT0t);//phase B
+		AdcSetupSOC(SOC2, ADCB1, TINT0t);//phase C
+		AdcStreamInit(SOC0, SOC2, ADCINT1, buf, 3*SETS);//SOC2's EOC throws ADCINT1, which triggers the DMA
+		AdcStreamStart();
+	//clock
+		TimerInit(100.0);//timer at 100kHz. Its interrupt is never registered, so only the ADC sees it.
+	EDIS;//disallow access to system control registers
+
+	while(1) {//loop forever waiting for interrupts
+		loopcnt++;//the control loop has the CPU to itself between half-buffers
+	}
+}
+
+interrupt void dmaISR(void) {
+	Uint16* half = AdcStreamReady();
+	Uint16 i;
+
+	if (half) {//nothing to read on the first transfer
+		sum[0] = 0; sum[1] = 0; sum[2] = 0;
+		for (i = 0; i < 3*SETS; i += 3) {
+			sum[0] += half[i];
+			sum[1] += half[i+1];
+			sum[2] += half[i+2];
+		}
+		GpioTogglePin(34);
+	}
+
+	dmacnt++;
+	IsrAck(DMACH1);//reset PIE flag
+}